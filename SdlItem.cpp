@@ -19,60 +19,138 @@
 
 #include "sdl.h"
 #include "SdlItem.h"
+#include "tracker.h"
+#include <utility>
+
+// Returned for items without extra data
+static const std::function<void()> noCb;
+static const std::function<void(int x, int y)> noOverCb;
+static const std::function<void(std::string)> noEditCb;
+static const std::string noText;
 
 /*****************************************************************************/
 SdlItem::SdlItem() :
-		m_rect(
-		{ -1, -1, 0, 0 }), m_animStartTick(0U), m_flip(SDL_FLIP_NONE), m_angle(0.0), m_zoomX(1.0), m_zoomY(1.0), m_user1(0), m_user2(0), m_overlay(false), m_animArray(), m_animOver(), m_defaultAnimOver(), m_animClick(), m_defaultAnimClick(), m_layout(
-				Layout::TOP_LEFT), m_animLoop(true), m_clicked(false), m_clickLeftCb(), m_clickRightCb(), m_doubleClickLeftCb(), m_doubleClickRightCb(), m_wheelUpCb(), m_wheelDownCb(), m_overCb(), m_text(), m_backGroudColor(
-				0U), m_font(nullptr), m_textTexture(nullptr), m_editable(false), m_editCb(), m_userPtr(nullptr), m_userString()
+		SdlItem(SiItemStore::getDefault())
+{
+}
+
+/*****************************************************************************/
+SdlItem::SdlItem(SiItemStore & store) :
+		m_store(&store), m_handle(store.create())
+{
+}
+
+/*****************************************************************************/
+SdlItem::SdlItem(const SdlItem & item) :
+		m_store(item.m_store), m_handle(item.m_store->clone(item.m_handle))
+{
+}
+
+/*****************************************************************************/
+SdlItem::SdlItem(SdlItem && item) noexcept :
+		m_store(item.m_store), m_handle(item.m_handle)
 {
+	item.m_handle = SiItemStore::NO_ITEM;
+}
+
+/*****************************************************************************/
+SdlItem & SdlItem::operator=(const SdlItem & item)
+{
+	if (this != &item)
+	{
+		SdlItem copy(item);
+		*this = std::move(copy);
+	}
+
+	return *this;
+}
+
+/*****************************************************************************/
+SdlItem & SdlItem::operator=(SdlItem && item) noexcept
+{
+	if (this != &item)
+	{
+		if (m_handle != SiItemStore::NO_ITEM)
+		{
+			m_store->destroy(m_handle);
+		}
+		m_store = item.m_store;
+		m_handle = item.m_handle;
+		item.m_handle = SiItemStore::NO_ITEM;
+	}
+
+	return *this;
 }
 
 /*****************************************************************************/
 SdlItem::~SdlItem()
 {
-	if (m_textTexture != nullptr)
+	if (m_handle != SiItemStore::NO_ITEM)
 	{
-		SDL_DestroyTexture (m_textTexture);
+		m_store->destroy(m_handle);
 	}
 }
 
+/*****************************************************************************/
+SiItemStore & SdlItem::getStore() const
+{
+	return *m_store;
+}
+
+/*****************************************************************************/
+SiItemHandle SdlItem::getHandle() const
+{
+	return m_handle;
+}
+
+/*****************************************************************************/
+int SdlItem::getIndex() const
+{
+	return m_store->getIndex(m_handle);
+}
+
 /*****************************************************************************/
 void SdlItem::setPos(const int x, const int y)
 {
-	m_rect.x = x;
-	m_rect.y = y;
+	SDL_Rect & rect = m_store->getRect(getIndex());
+
+	rect.x = x;
+	rect.y = y;
 }
 
 /*****************************************************************************/
 void SdlItem::setShape(const int width, const int height)
 {
-	m_rect.w = width;
-	m_rect.h = height;
+	SDL_Rect & rect = m_store->getRect(getIndex());
+
+	rect.w = width;
+	rect.h = height;
 }
 
 /*****************************************************************************/
 const std::vector<SiAnim*>& SdlItem::getAnim() const
 {
-	return m_animArray;
+	return m_store->getAnim(getIndex(), SiItemStore::AnimSet::DEFAULT);
 }
 
 /*****************************************************************************/
 void SdlItem::setAnim(const std::vector<SiAnim*>& animArray)
 {
-	m_animArray = animArray;
+	const int index = getIndex();
+	SDL_Rect & rect = m_store->getRect(index);
+
+	m_store->getAnim(index, SiItemStore::AnimSet::DEFAULT) = animArray;
 
 	for (auto && anim : animArray)
 	{
-		if (anim->getWidth() > m_rect.w)
+		if (anim->getWidth() > rect.w)
 		{
-			m_rect.w = anim->getWidth();
+			rect.w = anim->getWidth();
 		}
 
-		if (anim->getHeight() > m_rect.h)
+		if (anim->getHeight() > rect.h)
 		{
-			m_rect.h = anim->getHeight();
+			rect.h = anim->getHeight();
 		}
 	}
 }
@@ -80,10 +158,10 @@ void SdlItem::setAnim(const std::vector<SiAnim*>& animArray)
 /*****************************************************************************/
 void SdlItem::setAnim(SiAnim *anim)
 {
-	std::vector<SiAnim*> animArray;
-	animArray.push_back(anim);
+	std::vector<SiAnim*> & animArray = m_store->getAnim(getIndex(), SiItemStore::AnimSet::DEFAULT);
 
-	m_animArray = animArray;
+	animArray.clear();
+	animArray.push_back(anim);
 
 	setShape(anim->getWidth(), anim->getHeight());
 }
@@ -93,17 +171,19 @@ void SdlItem::pushAnim(SiAnim * const anim)
 {
 	int maxWidth = 0;
 	int maxHeight = 0;
+	const int index = getIndex();
 
 	maxWidth = anim->getWidth();
 	maxHeight = anim->getHeight();
 
-	m_animArray.push_back(anim);
+	m_store->getAnim(index, SiItemStore::AnimSet::DEFAULT).push_back(anim);
 
-	if (m_text.size() != 0)
+	const std::string & text = getText();
+	if (text.size() != 0)
 	{
 		int width = 0;
 		int height = 0;
-		sdl_get_string_size(m_font, m_text, &width, &height);
+		sdl_get_string_size(getFont(), text, &width, &height);
 		if (width > maxWidth)
 		{
 			maxWidth = width;
@@ -114,435 +194,539 @@ void SdlItem::pushAnim(SiAnim * const anim)
 		}
 	}
 
-	if (m_rect.w < maxWidth)
+	SDL_Rect & rect = m_store->getRect(index);
+	if (rect.w < maxWidth)
 	{
-		m_rect.w = maxWidth;
+		rect.w = maxWidth;
 	}
-	if (m_rect.h < maxHeight)
+	if (rect.h < maxHeight)
 	{
-		m_rect.h = maxHeight;
+		rect.h = maxHeight;
 	}
 }
 
 /*****************************************************************************/
 void SdlItem::clearAnim()
 {
-	m_animArray.clear();
+	m_store->getAnim(getIndex(), SiItemStore::AnimSet::DEFAULT).clear();
 }
 
 /*****************************************************************************/
 const std::vector<SiAnim*>& SdlItem::getAnimClick() const
 {
-	return m_animClick;
+	return m_store->getAnim(getIndex(), SiItemStore::AnimSet::CLICK);
 }
 
 /*****************************************************************************/
 void SdlItem::setAnimClick(const std::vector<SiAnim*>& animClick)
 {
-	m_animClick = animClick;
+	m_store->getAnim(getIndex(), SiItemStore::AnimSet::CLICK) = animClick;
 }
 
 /*****************************************************************************/
 void SdlItem::clearAnimClick()
 {
-	m_animClick.clear();
+	m_store->getAnim(getIndex(), SiItemStore::AnimSet::CLICK).clear();
 }
 
 /*****************************************************************************/
 const std::vector<SiAnim*>& SdlItem::getAnimOver() const
 {
-	return m_animOver;
+	return m_store->getAnim(getIndex(), SiItemStore::AnimSet::OVER);
 }
 
 /*****************************************************************************/
 void SdlItem::setAnimOver(const std::vector<SiAnim*>& animOver)
 {
-	m_animOver = animOver;
+	m_store->getAnim(getIndex(), SiItemStore::AnimSet::OVER) = animOver;
 }
 
 /*****************************************************************************/
 void SdlItem::setAnimOver(SiAnim *animOver)
 {
-	std::vector<SiAnim*> animArray;
-	animArray.push_back(animOver);
+	std::vector<SiAnim*> & animArray = m_store->getAnim(getIndex(), SiItemStore::AnimSet::OVER);
 
-	m_animOver = animArray;
+	animArray.clear();
+	animArray.push_back(animOver);
 }
 
 /*****************************************************************************/
 void SdlItem::clearAnimOver()
 {
-	m_animOver.clear();
+	m_store->getAnim(getIndex(), SiItemStore::AnimSet::OVER).clear();
 }
 
 /*****************************************************************************/
 const std::vector<SiAnim*>& SdlItem::getDefaultAnimClick() const
 {
-	return m_defaultAnimClick;
+	return m_store->getAnim(getIndex(), SiItemStore::AnimSet::DEFAULT_CLICK);
 }
 
 /*****************************************************************************/
 void SdlItem::setDefaultAnimClick(const std::vector<SiAnim*>& defaultAnimClick)
 {
-	m_defaultAnimClick = defaultAnimClick;
+	m_store->getAnim(getIndex(), SiItemStore::AnimSet::DEFAULT_CLICK) = defaultAnimClick;
 }
 
 /*****************************************************************************/
 const std::vector<SiAnim*>& SdlItem::getDefaultAnimOver() const
 {
-	return m_defaultAnimOver;
+	return m_store->getAnim(getIndex(), SiItemStore::AnimSet::DEFAULT_OVER);
 }
 
 /*****************************************************************************/
 void SdlItem::setDefaultAnimOver(const std::vector<SiAnim*>& defaultAnimOver)
 {
-	m_defaultAnimOver = defaultAnimOver;
+	m_store->getAnim(getIndex(), SiItemStore::AnimSet::DEFAULT_OVER) = defaultAnimOver;
 }
 
 /*****************************************************************************/
 SdlItem::Layout SdlItem::getLayout() const
 {
-	return m_layout;
+	if (m_store->isFlag(getIndex(), SiItemStore::FLAG_LAYOUT_CENTER) == true)
+	{
+		return Layout::CENTER;
+	}
+
+	return Layout::TOP_LEFT;
 }
 
 /*****************************************************************************/
 void SdlItem::setLayout(const SdlItem::Layout layout)
 {
-	m_layout = layout;
+	m_store->setFlag(getIndex(), SiItemStore::FLAG_LAYOUT_CENTER, layout == Layout::CENTER);
 }
 
 /*****************************************************************************/
 const SDL_Rect& SdlItem::getRect() const
 {
-	return m_rect;
+	return m_store->getRect(getIndex());
 }
 
 /*****************************************************************************/
 void SdlItem::setRect(const SDL_Rect& rect)
 {
-	m_rect = rect;
+	m_store->getRect(getIndex()) = rect;
 }
 
 /*****************************************************************************/
 void SdlItem::setRectX(const int x)
 {
-	m_rect.x = x;
+	m_store->getRect(getIndex()).x = x;
 }
 
 /*****************************************************************************/
 void SdlItem::setRectY(const int y)
 {
-	m_rect.y = y;
+	m_store->getRect(getIndex()).y = y;
 }
 
 /*****************************************************************************/
 double SdlItem::getAngle() const
 {
-	return m_angle;
+	return m_store->getTransform(getIndex()).angle;
 }
 
 /*****************************************************************************/
 void SdlItem::setAngle(double angle)
 {
-	m_angle = angle;
+	m_store->getTransform(getIndex()).angle = angle;
 }
 
 /*****************************************************************************/
 SDL_RendererFlip SdlItem::getFlip() const
 {
-	return m_flip;
+	return m_store->getTransform(getIndex()).flip;
 }
 
 /*****************************************************************************/
 void SdlItem::setFlip(SDL_RendererFlip flip)
 {
-	m_flip = flip;
+	m_store->getTransform(getIndex()).flip = flip;
 }
 
 /*****************************************************************************/
 double SdlItem::getZoomX() const
 {
-	return m_zoomX;
+	return m_store->getTransform(getIndex()).zoomX;
 }
 
 /*****************************************************************************/
 void SdlItem::setZoomX(double zoomX)
 {
-	m_zoomX = zoomX;
+	m_store->getTransform(getIndex()).zoomX = zoomX;
 }
 
 /*****************************************************************************/
 double SdlItem::getZoomY() const
 {
-	return m_zoomY;
+	return m_store->getTransform(getIndex()).zoomY;
 }
 
 /*****************************************************************************/
 void SdlItem::setZoomY(double zoomY)
 {
-	m_zoomY = zoomY;
+	m_store->getTransform(getIndex()).zoomY = zoomY;
 }
 
 /*****************************************************************************/
 Uint32 SdlItem::getAnimStartTick() const
 {
-	return m_animStartTick;
+	return m_store->getTransform(getIndex()).animStartTick;
 }
 
 /*****************************************************************************/
 void SdlItem::setAnimStartTick(Uint32 animStartTick)
 {
-	m_animStartTick = animStartTick;
+	m_store->getTransform(getIndex()).animStartTick = animStartTick;
 }
 
 /*****************************************************************************/
 bool SdlItem::isOverlay() const
 {
-	return m_overlay;
+	return m_store->isFlag(getIndex(), SiItemStore::FLAG_OVERLAY);
 }
 
 /*****************************************************************************/
 void SdlItem::setOverlay(bool overlay)
 {
-	m_overlay = overlay;
+	m_store->setFlag(getIndex(), SiItemStore::FLAG_OVERLAY, overlay);
 }
 
 /*****************************************************************************/
 bool SdlItem::isAnimLoop() const
 {
-	return m_animLoop;
+	return m_store->isFlag(getIndex(), SiItemStore::FLAG_ANIM_LOOP);
 }
 
 /*****************************************************************************/
 void SdlItem::setAnimLoop(bool animLoop)
 {
-	m_animLoop = animLoop;
+	m_store->setFlag(getIndex(), SiItemStore::FLAG_ANIM_LOOP, animLoop);
 }
 
 /*****************************************************************************/
 const std::function<void()>& SdlItem::getClickLeftCb() const
 {
-	return m_clickLeftCb;
+	if (m_store->isFlag(getIndex(), SiItemStore::HANDLER_CLICK_LEFT) == false)
+	{
+		return noCb;
+	}
+
+	return m_store->findHandlers(m_handle)->clickLeftCb;
 }
 
 /*****************************************************************************/
 void SdlItem::setClickLeftCb(const std::function<void()>& callBack)
 {
-	m_clickLeftCb = callBack;
+	m_store->getHandlers(m_handle).clickLeftCb = callBack;
+	m_store->setFlag(getIndex(), SiItemStore::HANDLER_CLICK_LEFT, bool(callBack) == true);
 }
 
 /*****************************************************************************/
 const std::function<void()>& SdlItem::getClickRightCb() const
 {
-	return m_clickRightCb;
+	if (m_store->isFlag(getIndex(), SiItemStore::HANDLER_CLICK_RIGHT) == false)
+	{
+		return noCb;
+	}
+
+	return m_store->findHandlers(m_handle)->clickRightCb;
 }
 
 /*****************************************************************************/
 void SdlItem::setClickRightCb(const std::function<void()>& clickRightCb)
 {
-	m_clickRightCb = clickRightCb;
+	m_store->getHandlers(m_handle).clickRightCb = clickRightCb;
+	m_store->setFlag(getIndex(), SiItemStore::HANDLER_CLICK_RIGHT, bool(clickRightCb) == true);
 }
 
 /*****************************************************************************/
 const std::function<void()>& SdlItem::getDoubleClickLeftCb() const
 {
-	return m_doubleClickLeftCb;
+	if (m_store->isFlag(getIndex(), SiItemStore::HANDLER_DOUBLE_CLICK_LEFT) == false)
+	{
+		return noCb;
+	}
+
+	return m_store->findHandlers(m_handle)->doubleClickLeftCb;
 }
 
 /*****************************************************************************/
 void SdlItem::setDoubleClickLeftCb(const std::function<void()>& doubleClickLeftCb)
 {
-	m_doubleClickLeftCb = doubleClickLeftCb;
+	m_store->getHandlers(m_handle).doubleClickLeftCb = doubleClickLeftCb;
+	m_store->setFlag(getIndex(), SiItemStore::HANDLER_DOUBLE_CLICK_LEFT, bool(doubleClickLeftCb) == true);
 }
 
 /*****************************************************************************/
 const std::function<void()>& SdlItem::getDoubleClickRightCb() const
 {
-	return m_doubleClickRightCb;
+	if (m_store->isFlag(getIndex(), SiItemStore::HANDLER_DOUBLE_CLICK_RIGHT) == false)
+	{
+		return noCb;
+	}
+
+	return m_store->findHandlers(m_handle)->doubleClickRightCb;
 }
 
 /*****************************************************************************/
 void SdlItem::setDoubleClickRightCb(const std::function<void()>& doubleClickRightCb)
 {
-	m_doubleClickRightCb = doubleClickRightCb;
+	m_store->getHandlers(m_handle).doubleClickRightCb = doubleClickRightCb;
+	m_store->setFlag(getIndex(), SiItemStore::HANDLER_DOUBLE_CLICK_RIGHT, bool(doubleClickRightCb) == true);
 }
 
 /*****************************************************************************/
 const std::function<void(int x, int y)>& SdlItem::getOverCb() const
 {
-	return m_overCb;
+	if (m_store->isFlag(getIndex(), SiItemStore::HANDLER_OVER) == false)
+	{
+		return noOverCb;
+	}
+
+	return m_store->findHandlers(m_handle)->overCb;
 }
 
 /*****************************************************************************/
 void SdlItem::setOverCb(const std::function<void(int x, int y)>& overCb)
 {
-	m_overCb = overCb;
+	m_store->getHandlers(m_handle).overCb = overCb;
+	m_store->setFlag(getIndex(), SiItemStore::HANDLER_OVER, bool(overCb) == true);
 }
 
 /*****************************************************************************/
 const std::function<void()>& SdlItem::getWheelDownCb() const
 {
-	return m_wheelDownCb;
+	if (m_store->isFlag(getIndex(), SiItemStore::HANDLER_WHEEL_DOWN) == false)
+	{
+		return noCb;
+	}
+
+	return m_store->findHandlers(m_handle)->wheelDownCb;
 }
 
 /*****************************************************************************/
 void SdlItem::setWheelDownCb(const std::function<void()>& wheelDownCb)
 {
-	m_wheelDownCb = wheelDownCb;
+	m_store->getHandlers(m_handle).wheelDownCb = wheelDownCb;
+	m_store->setFlag(getIndex(), SiItemStore::HANDLER_WHEEL_DOWN, bool(wheelDownCb) == true);
 }
 
 /*****************************************************************************/
 const std::function<void()>& SdlItem::getWheelUpCb() const
 {
-	return m_wheelUpCb;
+	if (m_store->isFlag(getIndex(), SiItemStore::HANDLER_WHEEL_UP) == false)
+	{
+		return noCb;
+	}
+
+	return m_store->findHandlers(m_handle)->wheelUpCb;
 }
 
 /*****************************************************************************/
 void SdlItem::setWheelUpCb(const std::function<void()>& wheelUpCb)
 {
-	m_wheelUpCb = wheelUpCb;
+	m_store->getHandlers(m_handle).wheelUpCb = wheelUpCb;
+	m_store->setFlag(getIndex(), SiItemStore::HANDLER_WHEEL_UP, bool(wheelUpCb) == true);
 }
 
 /*****************************************************************************/
 bool SdlItem::isEditable() const
 {
-	return m_editable;
+	return m_store->isFlag(getIndex(), SiItemStore::FLAG_EDITABLE);
 }
 
 /*****************************************************************************/
 void SdlItem::setEditable(bool isEditable)
 {
-	m_editable = isEditable;
+	m_store->setFlag(getIndex(), SiItemStore::FLAG_EDITABLE, isEditable);
 }
 
 /*****************************************************************************/
 SDL_Texture* SdlItem::getTextTexture() const
 {
-	return m_textTexture;
+	const SiItemStore::Extra * extra = m_store->findExtra(m_handle);
+	if (extra == nullptr)
+	{
+		return nullptr;
+	}
+
+	return extra->textTexture;
 }
 
 /*****************************************************************************/
 void SdlItem::setTextTexture(SDL_Texture* textTexture)
 {
-	m_textTexture = textTexture;
+	m_store->getExtra(m_handle).textTexture = textTexture;
 }
 
 /*****************************************************************************/
 const std::string& SdlItem::getText() const
 {
-	return m_text;
+	const SiItemStore::Extra * extra = m_store->findExtra(m_handle);
+	if (extra == nullptr)
+	{
+		return noText;
+	}
+
+	return extra->text;
 }
 
 /*****************************************************************************/
 void SdlItem::setText(const std::string& text)
 {
-	m_text = text;
+	m_store->setText(m_handle, text);
 }
 
 /*****************************************************************************/
 void SdlItem::addToText(const std::string& text)
 {
-	m_text = m_text + text;
+	m_store->setText(m_handle, getText() + text);
 }
 
 /*****************************************************************************/
 void SdlItem::removeFromText(const int quantity)
 {
-	m_text = m_text.substr(0, m_text.size() - quantity);
+	const std::string & text = getText();
+
+	m_store->setText(m_handle, text.substr(0, text.size() - quantity));
 }
 
 /*****************************************************************************/
 TTF_Font* SdlItem::getFont() const
 {
-	return m_font;
+	const SiItemStore::Extra * extra = m_store->findExtra(m_handle);
+	if (extra == nullptr)
+	{
+		return nullptr;
+	}
+
+	return extra->font;
 }
 
 /*****************************************************************************/
 void SdlItem::setFont(TTF_Font* font)
 {
-	m_font = font;
+	m_store->getExtra(m_handle).font = font;
 }
 
 /*****************************************************************************/
 Uint32 SdlItem::getBackGroudColor() const
 {
-	return m_backGroudColor;
+	const SiItemStore::Extra * extra = m_store->findExtra(m_handle);
+	if (extra == nullptr)
+	{
+		return 0U;
+	}
+
+	return extra->backGroudColor;
 }
 
 /*****************************************************************************/
 void SdlItem::setBackGroudColor(Uint32 backGroudColor)
 {
-	m_backGroudColor = backGroudColor;
+	m_store->getExtra(m_handle).backGroudColor = backGroudColor;
 }
 
 /*****************************************************************************/
 const std::function<void(std::string)>& SdlItem::getEditCb() const
 {
-	return m_editCb;
+	if (m_store->isFlag(getIndex(), SiItemStore::HANDLER_EDIT) == false)
+	{
+		return noEditCb;
+	}
+
+	return m_store->findHandlers(m_handle)->editCb;
 }
 
 /*****************************************************************************/
 void SdlItem::setEditCb(const std::function<void(std::string)>& editCb)
 {
-	m_editCb = editCb;
+	m_store->getHandlers(m_handle).editCb = editCb;
+	m_store->setFlag(getIndex(), SiItemStore::HANDLER_EDIT, bool(editCb) == true);
 }
 
 /*****************************************************************************/
 int SdlItem::getUser1() const
 {
-	return m_user1;
+	const SiItemStore::Extra * extra = m_store->findExtra(m_handle);
+	if (extra == nullptr)
+	{
+		return 0;
+	}
+
+	return extra->user1;
 }
 
 /*****************************************************************************/
 void SdlItem::setUser1(int user1)
 {
-	m_user1 = user1;
+	m_store->getExtra(m_handle).user1 = user1;
 }
 
 /*****************************************************************************/
 int SdlItem::getUser2() const
 {
-	return m_user2;
+	const SiItemStore::Extra * extra = m_store->findExtra(m_handle);
+	if (extra == nullptr)
+	{
+		return 0;
+	}
+
+	return extra->user2;
 }
 
 /*****************************************************************************/
 void SdlItem::setUser2(int user2)
 {
-	m_user2 = user2;
+	m_store->getExtra(m_handle).user2 = user2;
 }
 
 /*****************************************************************************/
 const std::string SdlItem::getUserString() const
 {
-	return m_userString;
+	const SiItemStore::Extra * extra = m_store->findExtra(m_handle);
+	if (extra == nullptr)
+	{
+		return noText;
+	}
+
+	return extra->userString;
 }
 
 /*****************************************************************************/
 void SdlItem::setUserString(const std::string & userString)
 {
-	m_userString = userString;
+	m_store->getExtra(m_handle).userString = userString;
 }
 
 /*****************************************************************************/
 const void* SdlItem::getUserPtr() const
 {
-	return m_userPtr;
+	const SiItemStore::Extra * extra = m_store->findExtra(m_handle);
+	if (extra == nullptr)
+	{
+		return nullptr;
+	}
+
+	return extra->userPtr;
 }
 
 /*****************************************************************************/
 void SdlItem::setUserPtr(const void* userPtr)
 {
-	m_userPtr = userPtr;
+	m_store->getExtra(m_handle).userPtr = userPtr;
 }
 
 /*****************************************************************************/
 bool SdlItem::isClicked() const
 {
-	return m_clicked;
+	return m_store->isFlag(getIndex(), SiItemStore::FLAG_CLICKED);
 }
 
 /*****************************************************************************/
 void SdlItem::setClicked(bool clicked)
 {
-	m_clicked = clicked;
+	m_store->setFlag(getIndex(), SiItemStore::FLAG_CLICKED, clicked);
 }
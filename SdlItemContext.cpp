@@ -0,0 +1,82 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "SdlItemContext.h"
+#include "SiTexture.h"
+
+/*****************************************************************************/
+SdlItemContext::SdlItemContext() :
+		m_state(), m_commandQueue()
+{
+}
+
+/******************************************************************************
+ Nothing to destroy once SDL_Quit() was called by sdl_cleanup()
+ *****************************************************************************/
+SdlItemContext::~SdlItemContext()
+{
+	if (SDL_WasInit(SDL_INIT_VIDEO) == 0)
+	{
+		return;
+	}
+
+	SiTexture::releaseAll(*this);
+
+	if (m_state.renderer != nullptr)
+	{
+		SDL_DestroyRenderer(m_state.renderer);
+	}
+
+	if (m_state.window != nullptr)
+	{
+		SDL_DestroyWindow(m_state.window);
+	}
+}
+
+/*****************************************************************************/
+SdlItemContext::State & SdlItemContext::getState()
+{
+	return m_state;
+}
+
+/*****************************************************************************/
+SiCommandQueue & SdlItemContext::getCommandQueue()
+{
+	return m_commandQueue;
+}
+
+/*****************************************************************************/
+SDL_Window * SdlItemContext::getWindow() const
+{
+	return m_state.window;
+}
+
+/*****************************************************************************/
+SDL_Renderer * SdlItemContext::getRenderer() const
+{
+	return m_state.renderer;
+}
+
+/*****************************************************************************/
+SdlItemContext & SdlItemContext::getDefault()
+{
+	static SdlItemContext context;
+
+	return context;
+}
@@ -22,7 +22,7 @@
 
 /*****************************************************************************/
 SiAnim::SiAnim() :
-		m_textureArray(), m_width(0), m_height(0), m_delayArray(), m_totalDuration(0U)
+		m_frameArray(), m_textureArray(), m_width(0), m_height(0), m_delayArray(), m_totalDuration(0U), m_stream(), m_levelArray()
 {
 }
 
@@ -64,8 +64,6 @@ const std::vector<std::shared_ptr<SiTexture>>& SiAnim::getTextureArray() const
 /*****************************************************************************/
 void SiAnim::pushTexture(SDL_Texture* texture)
 {
-	m_textureArray.push_back(std::make_shared<SiTexture>(texture));
-
 	Uint32 format = 0;
 	int access = 0;
 	int width = 0;
@@ -73,22 +71,202 @@ void SiAnim::pushTexture(SDL_Texture* texture)
 
 	SDL_QueryTexture(texture, &format, &access, &width, &height);
 
-	if (m_width < width)
+	pushTexture(texture,
+	{ 0, 0, width, height }, NO_KEY_FRAME);
+}
+
+/******************************************************************************
+ texture covers rect of the anim.
+ If keyFrame is not NO_KEY_FRAME, texture is drawn over frame keyFrame
+ (which must not be a delta frame itself)
+ *****************************************************************************/
+void SiAnim::pushTexture(SDL_Texture* texture, const SDL_Rect & rect, const int keyFrame)
+{
+	SDL_Rect source =
+	{ 0, 0, rect.w, rect.h };
+
+	pushFrame(std::make_shared<SiTexture>(texture), source, rect, keyFrame);
+}
+
+/*****************************************************************************/
+void SiAnim::pushSurface(SDL_Surface* surface, const SDL_Rect & rect, const int keyFrame)
+{
+	SDL_Rect source =
+	{ 0, 0, rect.w, rect.h };
+
+	pushFrame(std::make_shared<SiTexture>(surface), source, rect, keyFrame);
+}
+
+/*****************************************************************************/
+void SiAnim::pushTextureArea(const std::shared_ptr<SiTexture> & texture, const SDL_Rect & source, const SDL_Rect & rect)
+{
+	pushFrame(texture, source, rect, NO_KEY_FRAME);
+}
+
+/*****************************************************************************/
+void SiAnim::pushFrameCopy(const int index)
+{
+	// Copied before pushing, which may reallocate the arrays
+	const std::shared_ptr<SiTexture> texture = m_textureArray[index];
+	const Frame frame = m_frameArray[index];
+
+	pushFrame(texture, frame.source, frame.rect, frame.keyFrame);
+
+	for (auto && level : m_levelArray)
+	{
+		level->pushFrameCopy(index);
+	}
+}
+
+/*****************************************************************************/
+void SiAnim::pushEmptyFrame()
+{
+	SDL_Rect rect =
+	{ 0, 0, 0, 0 };
+	SDL_Texture * texture = nullptr;
+
+	pushFrame(std::make_shared<SiTexture>(texture), rect, rect, NO_KEY_FRAME);
+
+	for (auto && level : m_levelArray)
+	{
+		level->pushEmptyFrame();
+	}
+}
+
+/*****************************************************************************/
+static bool is_same_rect(const SDL_Rect & a, const SDL_Rect & b)
+{
+	return (a.x == b.x) && (a.y == b.y) && (a.w == b.w) && (a.h == b.h);
+}
+
+/*****************************************************************************/
+bool SiAnim::isSameFrame(const int first, const int second) const
+{
+	const Frame & a = m_frameArray[first];
+	const Frame & b = m_frameArray[second];
+
+	return (a.texture == b.texture) && (is_same_rect(a.source, b.source) == true) && (is_same_rect(a.rect, b.rect) == true) && (a.keyFrame == b.keyFrame);
+}
+
+/*****************************************************************************/
+void SiAnim::compactFrames(const std::vector<int> & newIndexArray, const int newQty)
+{
+	int newIndex = 0;
+
+	for (int i = 0; i < (int) newIndexArray.size(); i++)
+	{
+		if (newIndexArray[i] != newIndex)
+		{
+			continue;
+		}
+
+		m_textureArray[newIndex] = m_textureArray[i];
+		m_frameArray[newIndex] = m_frameArray[i];
+		if (m_frameArray[newIndex].keyFrame != NO_KEY_FRAME)
+		{
+			m_frameArray[newIndex].keyFrame = newIndexArray[m_frameArray[newIndex].keyFrame];
+		}
+		newIndex++;
+	}
+
+	m_textureArray.resize(newQty);
+	m_frameArray.resize(newQty);
+}
+
+/*****************************************************************************/
+void SiAnim::mergeRepeatedFrames()
+{
+	const int frameQty = getFrameQty();
+
+	// Without one delay per frame, merged delays could not be summed
+	if ((m_stream != nullptr) || ((int) m_delayArray.size() != frameQty))
+	{
+		return;
+	}
+
+	std::vector<int> newIndexArray(frameQty, 0);
+	std::vector<Uint32> delayArray;
+
+	for (int i = 0; i < frameQty; i++)
+	{
+		if ((i > 0) && (isSameFrame(i - 1, i) == true))
+		{
+			newIndexArray[i] = delayArray.size() - 1;
+			delayArray.back() += m_delayArray[i];
+		}
+		else
+		{
+			newIndexArray[i] = delayArray.size();
+			delayArray.push_back(m_delayArray[i]);
+		}
+	}
+
+	if ((int) delayArray.size() == frameQty)
+	{
+		return;
+	}
+
+	compactFrames(newIndexArray, delayArray.size());
+	for (auto && level : m_levelArray)
+	{
+		level->compactFrames(newIndexArray, delayArray.size());
+	}
+
+	m_delayArray = delayArray;
+}
+
+/*****************************************************************************/
+void SiAnim::pushFrame(const std::shared_ptr<SiTexture> & texture, const SDL_Rect & source, const SDL_Rect & rect, const int keyFrame)
+{
+	Frame frame;
+	frame.texture = texture.get();
+	frame.source = source;
+	frame.rect = rect;
+	frame.keyFrame = keyFrame;
+
+	m_textureArray.push_back(texture);
+	m_frameArray.push_back(frame);
+
+	if (m_width < rect.x + rect.w)
 	{
-		m_width = width;
+		m_width = rect.x + rect.w;
 	}
-	if (m_height < height)
+	if (m_height < rect.y + rect.h)
 	{
-		m_height = height;
+		m_height = rect.y + rect.h;
 	}
 }
 
 /*****************************************************************************/
-std::shared_ptr<SiTexture> SiAnim::getTexture(const int index) const
+const std::shared_ptr<SiTexture> & SiAnim::getTexture(const int index) const
 {
 	return m_textureArray[index];
 }
 
+/*****************************************************************************/
+const SiAnim::Frame & SiAnim::getFrame(const int index) const
+{
+	return m_frameArray[index];
+}
+
+/*****************************************************************************/
+const SDL_Rect & SiAnim::getSourceRect(const int index) const
+{
+	return m_frameArray[index].source;
+}
+
+/*****************************************************************************/
+const SDL_Rect & SiAnim::getFrameRect(const int index) const
+{
+	return m_frameArray[index].rect;
+}
+
+/*****************************************************************************/
+int SiAnim::getKeyFrame(const int index) const
+{
+	return m_frameArray[index].keyFrame;
+}
+
 /*****************************************************************************/
 Uint32 SiAnim::getTotalDuration() const
 {
@@ -104,7 +282,7 @@ void SiAnim::setTotalDuration(Uint32 totalDuration)
 /*****************************************************************************/
 int SiAnim::getFrameQty() const
 {
-	return m_textureArray.size();
+	return m_frameArray.size();
 }
 
 /*****************************************************************************/
@@ -124,3 +302,59 @@ void SiAnim::pushDelay(const Uint32 delay)
 {
 	m_delayArray.push_back(delay);
 }
+
+/*****************************************************************************/
+const std::shared_ptr<SiStream>& SiAnim::getStream() const
+{
+	return m_stream;
+}
+
+/*****************************************************************************/
+void SiAnim::setStream(const std::shared_ptr<SiStream>& stream)
+{
+	m_stream = stream;
+}
+
+/*****************************************************************************/
+int SiAnim::getLevelQty() const
+{
+	return m_levelArray.size();
+}
+
+/*****************************************************************************/
+const SiAnim & SiAnim::getLevel(const int index) const
+{
+	return *m_levelArray[index];
+}
+
+/*****************************************************************************/
+SiAnim & SiAnim::getLevel(const int index)
+{
+	return *m_levelArray[index];
+}
+
+/*****************************************************************************/
+void SiAnim::pushLevel(SiAnim * level)
+{
+	m_levelArray.emplace_back(level);
+}
+
+/*****************************************************************************/
+const SiAnim & SiAnim::getLevelForScale(const double scale) const
+{
+	const SiAnim * level = this;
+	double levelScale = scale;
+
+	for (auto && nextLevel : m_levelArray)
+	{
+		if (levelScale > 0.5)
+		{
+			break;
+		}
+
+		level = nextLevel.get();
+		levelScale *= 2.0;
+	}
+
+	return *level;
+}
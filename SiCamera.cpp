@@ -0,0 +1,182 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "sdl.h"
+#include "SiCamera.h"
+
+/*****************************************************************************/
+SiCamera::SiCamera() :
+		m_viewport(), m_x(0.0), m_y(0.0), m_zoom(1.0), m_oldX(0.0), m_oldY(0.0), m_oldZoom(1.0), m_currentX(0.0), m_currentY(0.0), m_currentZoom(1.0), m_moveTick(0U), m_stepX(0.0), m_stepY(0.0), m_stepZoom(1.0)
+{
+}
+
+/*****************************************************************************/
+SiCamera::~SiCamera()
+{
+}
+
+/*****************************************************************************/
+const SDL_Rect & SiCamera::getViewport() const
+{
+	return m_viewport;
+}
+
+/*****************************************************************************/
+void SiCamera::setViewport(const SDL_Rect & viewport)
+{
+	m_viewport = viewport;
+}
+
+/*****************************************************************************/
+double SiCamera::getX() const
+{
+	return m_x;
+}
+
+/*****************************************************************************/
+void SiCamera::setX(const double x, const Uint32 tick)
+{
+	m_oldX = m_currentX;
+	if (x != m_x)
+	{
+		m_x = x;
+		m_moveTick = tick;
+	}
+}
+
+/*****************************************************************************/
+double SiCamera::getY() const
+{
+	return m_y;
+}
+
+/*****************************************************************************/
+void SiCamera::setY(const double y, const Uint32 tick)
+{
+	m_oldY = m_currentY;
+	if (y != m_y)
+	{
+		m_y = y;
+		m_moveTick = tick;
+	}
+}
+
+/*****************************************************************************/
+double SiCamera::getZoom() const
+{
+	return m_zoom;
+}
+
+/*****************************************************************************/
+void SiCamera::setZoom(const double zoom, const Uint32 tick)
+{
+	if (zoom != m_zoom)
+	{
+		m_oldZoom = m_currentZoom;
+		m_zoom = zoom;
+		m_moveTick = tick;
+	}
+}
+
+/*****************************************************************************/
+void SiCamera::forceX(const double x)
+{
+	m_x = x;
+	m_oldX = x;
+	m_currentX = x;
+	m_stepX = x;
+}
+
+/*****************************************************************************/
+void SiCamera::forceY(const double y)
+{
+	m_y = y;
+	m_oldY = y;
+	m_currentY = y;
+	m_stepY = y;
+}
+
+/*****************************************************************************/
+void SiCamera::forceZoom(const double zoom)
+{
+	m_zoom = zoom;
+	m_oldZoom = zoom;
+	m_currentZoom = zoom;
+	m_stepZoom = zoom;
+}
+
+/*****************************************************************************/
+double SiCamera::getCurrentX() const
+{
+	return m_currentX;
+}
+
+/*****************************************************************************/
+double SiCamera::getCurrentY() const
+{
+	return m_currentY;
+}
+
+/*****************************************************************************/
+double SiCamera::getCurrentZoom() const
+{
+	return m_currentZoom;
+}
+
+/******************************************************************************
+ Moves last VIRTUAL_CAMERA_ANIM_DURATION ms
+ *****************************************************************************/
+void SiCamera::update(const Uint32 tick)
+{
+	if (m_moveTick + VIRTUAL_CAMERA_ANIM_DURATION > tick)
+	{
+		const double ratio = (double) (tick - m_moveTick) / (double) VIRTUAL_CAMERA_ANIM_DURATION;
+
+		m_currentX = m_oldX + (m_x - m_oldX) * ratio;
+		m_currentY = m_oldY + (m_y - m_oldY) * ratio;
+		m_currentZoom = m_oldZoom + (m_zoom - m_oldZoom) * ratio;
+	}
+	else
+	{
+		m_oldX = m_x;
+		m_currentX = m_x;
+
+		m_oldY = m_y;
+		m_currentY = m_y;
+
+		m_oldZoom = m_zoom;
+		m_currentZoom = m_zoom;
+	}
+}
+
+/*****************************************************************************/
+void SiCamera::saveStep()
+{
+	m_stepX = m_x;
+	m_stepY = m_y;
+	m_stepZoom = m_zoom;
+}
+
+/*****************************************************************************/
+void SiCamera::interpolateStep(const double alpha)
+{
+	m_currentX = m_stepX + (m_x - m_stepX) * alpha;
+	m_currentY = m_stepY + (m_y - m_stepY) * alpha;
+	m_currentZoom = m_stepZoom + (m_zoom - m_stepZoom) * alpha;
+}
@@ -0,0 +1,124 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "SiCommandQueue.h"
+
+/*****************************************************************************/
+SiCommandQueue::SiCommandQueue() :
+		m_head(nullptr), m_tail(nullptr)
+{
+	// The list always holds a popped node, so push and pop never touch the
+	// same node pointer
+	m_tail = new Node;
+	m_tail->next = nullptr;
+	m_head = m_tail;
+}
+
+/*****************************************************************************/
+SiCommandQueue::~SiCommandQueue()
+{
+	Command command;
+	while (pop(command) == true)
+	{
+	}
+
+	delete m_tail;
+}
+
+/*****************************************************************************/
+void SiCommandQueue::push(Node * node)
+{
+	node->next.store(nullptr, std::memory_order_relaxed);
+
+	Node * previous = m_head.exchange(node, std::memory_order_acq_rel);
+	// Until this store, pop() sees the queue as ending at previous
+	previous->next.store(node, std::memory_order_release);
+}
+
+/*****************************************************************************/
+void SiCommandQueue::pushPosition(SiItemStore & store, const SiItemHandle handle, const int x, const int y)
+{
+	Node * node = new Node;
+	node->command.type = Type::POSITION;
+	node->command.store = &store;
+	node->command.handle = handle;
+	node->command.x = x;
+	node->command.y = y;
+
+	push(node);
+}
+
+/*****************************************************************************/
+void SiCommandQueue::pushAnim(SiItemStore & store, const SiItemHandle handle, SiAnim * anim)
+{
+	if (anim == nullptr)
+	{
+		return;
+	}
+
+	Node * node = new Node;
+	node->command.type = Type::ANIM;
+	node->command.store = &store;
+	node->command.handle = handle;
+	node->command.anim = anim;
+
+	push(node);
+}
+
+/*****************************************************************************/
+void SiCommandQueue::pushText(SiItemStore & store, const SiItemHandle handle, const std::string & text)
+{
+	Node * node = new Node;
+	node->command.type = Type::TEXT;
+	node->command.store = &store;
+	node->command.handle = handle;
+	node->command.text = text;
+
+	push(node);
+}
+
+/*****************************************************************************/
+void SiCommandQueue::pushCamera(const int x, const int y, const double z)
+{
+	Node * node = new Node;
+	node->command.type = Type::CAMERA;
+	node->command.x = x;
+	node->command.y = y;
+	node->command.z = z;
+
+	push(node);
+}
+
+/*****************************************************************************/
+bool SiCommandQueue::pop(Command & command)
+{
+	Node * next = m_tail->next.load(std::memory_order_acquire);
+	if (next == nullptr)
+	{
+		return false;
+	}
+
+	command = std::move(next->command);
+
+	// next becomes the popped node kept in the list
+	delete m_tail;
+	m_tail = next;
+
+	return true;
+}
@@ -0,0 +1,497 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "SiItemStore.h"
+#include "tracker.h"
+#include <algorithm>
+
+/*****************************************************************************/
+SiItemStore::SiItemStore() :
+		m_qty(0), m_indexArray(), m_generationArray(), m_extraIndexArray(), m_handlersIndexArray(), m_freeSlotArray(), m_handleArray(), m_orderKeyArray(), m_nextOrderKey(0U), m_orderArray(), m_isOrderDirty(false), m_rectArray(), m_previousPosArray(), m_flagArray(), m_transformArray(), m_animArray(), m_extraPool(), m_freeExtraArray(), m_handlersPool(), m_freeHandlersArray()
+{
+}
+
+/******************************************************************************
+ Nothing to destroy once SDL_Quit() was called, text textures were
+ destroyed with the renderer
+ *****************************************************************************/
+SiItemStore::~SiItemStore()
+{
+	if (SDL_WasInit(SDL_INIT_VIDEO) == 0)
+	{
+		return;
+	}
+
+	// Entries of destroyed items have no texture
+	for (auto && extra : m_extraPool)
+	{
+		tracker_destroy_texture(extra.textTexture);
+		extra.textTexture = nullptr;
+	}
+}
+
+/*****************************************************************************/
+Uint32 SiItemStore::getSlot(const SiItemHandle handle)
+{
+	return (Uint32) (handle & 0xFFFFFFFFULL);
+}
+
+/*****************************************************************************/
+SiItemHandle SiItemStore::create()
+{
+	Uint32 slot = 0U;
+
+	if (m_freeSlotArray.empty() == false)
+	{
+		slot = m_freeSlotArray.back();
+		m_freeSlotArray.pop_back();
+	}
+	else
+	{
+		slot = m_indexArray.size();
+		m_indexArray.push_back(-1);
+		m_generationArray.push_back(0U);
+		m_extraIndexArray.push_back(-1);
+		m_handlersIndexArray.push_back(-1);
+	}
+
+	const SiItemHandle handle = ((SiItemHandle) m_generationArray[slot] << 32) | slot;
+	const int index = m_qty;
+
+	SDL_Rect rect =
+	{ -1, -1, 0, 0 };
+	SDL_Point previousPos =
+	{ -1, -1 };
+
+	if (index == (int) m_handleArray.size())
+	{
+		m_handleArray.push_back(handle);
+		m_orderKeyArray.push_back(m_nextOrderKey);
+		m_rectArray.push_back(rect);
+		m_previousPosArray.push_back(previousPos);
+		m_flagArray.push_back(FLAG_ANIM_LOOP | FLAG_SNAP);
+		m_transformArray.push_back(Transform());
+		for (auto && animArray : m_animArray)
+		{
+			animArray.emplace_back();
+		}
+	}
+	else
+	{
+		// Recycled entry, its anim arrays were cleared when it was destroyed
+		m_handleArray[index] = handle;
+		m_orderKeyArray[index] = m_nextOrderKey;
+		m_rectArray[index] = rect;
+		m_previousPosArray[index] = previousPos;
+		m_flagArray[index] = FLAG_ANIM_LOOP | FLAG_SNAP;
+		m_transformArray[index] = Transform();
+	}
+
+	m_indexArray[slot] = index;
+	m_qty++;
+	m_nextOrderKey++;
+
+	// The new item has the greatest key
+	if (m_isOrderDirty == false)
+	{
+		m_orderArray.push_back(index);
+	}
+
+	return handle;
+}
+
+/*****************************************************************************/
+SiItemHandle SiItemStore::clone(const SiItemHandle handle)
+{
+	const SiItemHandle cloneHandle = create();
+	const int index = getIndex(handle);
+	const int cloneIndex = getIndex(cloneHandle);
+
+	m_rectArray[cloneIndex] = m_rectArray[index];
+	m_previousPosArray[cloneIndex] = m_previousPosArray[index];
+	m_flagArray[cloneIndex] = m_flagArray[index];
+	m_transformArray[cloneIndex] = m_transformArray[index];
+	for (auto && animArray : m_animArray)
+	{
+		animArray[cloneIndex] = animArray[index];
+	}
+
+	if (findExtra(handle) != nullptr)
+	{
+		// getExtra() may move the pool, the source is found afterwards
+		Extra & cloneExtra = getExtra(cloneHandle);
+		cloneExtra = *findExtra(handle);
+		// Each item destroys its own texture, it is rendered again when drawn
+		cloneExtra.textTexture = nullptr;
+	}
+
+	if (findHandlers(handle) != nullptr)
+	{
+		Handlers & cloneHandlers = getHandlers(cloneHandle);
+		cloneHandlers = *findHandlers(handle);
+	}
+
+	return cloneHandle;
+}
+
+/******************************************************************************
+ Reset extra data, keeping the capacity of its strings
+ *****************************************************************************/
+static void reset_extra(SiItemStore::Extra & extra)
+{
+	if (extra.textTexture != nullptr)
+	{
+		tracker_destroy_texture(extra.textTexture);
+		extra.textTexture = nullptr;
+	}
+
+	extra.text.clear();
+	extra.backGroudColor = 0U;
+	extra.font = nullptr;
+	extra.user1 = 0;
+	extra.user2 = 0;
+	extra.userPtr = nullptr;
+	extra.userString.clear();
+}
+
+/*****************************************************************************/
+static void reset_handlers(SiItemStore::Handlers & handlers)
+{
+	handlers.clickLeftCb = nullptr;
+	handlers.clickRightCb = nullptr;
+	handlers.doubleClickLeftCb = nullptr;
+	handlers.doubleClickRightCb = nullptr;
+	handlers.wheelUpCb = nullptr;
+	handlers.wheelDownCb = nullptr;
+	handlers.overCb = nullptr;
+	handlers.editCb = nullptr;
+}
+
+/*****************************************************************************/
+void SiItemStore::destroy(const SiItemHandle handle)
+{
+	if (isValid(handle) == false)
+	{
+		return;
+	}
+
+	const Uint32 slot = getSlot(handle);
+
+	if (m_extraIndexArray[slot] != -1)
+	{
+		reset_extra(m_extraPool[m_extraIndexArray[slot]]);
+		m_freeExtraArray.push_back(m_extraIndexArray[slot]);
+		m_extraIndexArray[slot] = -1;
+	}
+
+	if (m_handlersIndexArray[slot] != -1)
+	{
+		reset_handlers(m_handlersPool[m_handlersIndexArray[slot]]);
+		m_freeHandlersArray.push_back(m_handlersIndexArray[slot]);
+		m_handlersIndexArray[slot] = -1;
+	}
+
+	// Keep arrays dense by moving the last item to the free index, the
+	// creation order is kept by the order keys.
+	// The destroyed item's anim arrays go to the free entry to be reused.
+	const int index = m_indexArray[slot];
+	const int last = m_qty - 1;
+
+	if (index != last)
+	{
+		m_handleArray[index] = m_handleArray[last];
+		m_orderKeyArray[index] = m_orderKeyArray[last];
+		m_rectArray[index] = m_rectArray[last];
+		m_previousPosArray[index] = m_previousPosArray[last];
+		m_flagArray[index] = m_flagArray[last];
+		m_transformArray[index] = m_transformArray[last];
+		for (auto && animArray : m_animArray)
+		{
+			animArray[index].swap(animArray[last]);
+		}
+		m_indexArray[getSlot(m_handleArray[index])] = index;
+		m_isOrderDirty = true;
+	}
+	else if ((m_isOrderDirty == false) && (m_orderArray.empty() == false) && (m_orderArray.back() == last))
+	{
+		// Last created item, the order array stays sorted
+		m_orderArray.pop_back();
+	}
+	else
+	{
+		m_isOrderDirty = true;
+	}
+
+	for (auto && animArray : m_animArray)
+	{
+		animArray[last].clear();
+	}
+
+	m_qty--;
+	m_indexArray[slot] = -1;
+	m_generationArray[slot]++;
+	m_freeSlotArray.push_back(slot);
+}
+
+/*****************************************************************************/
+void SiItemStore::clear()
+{
+	// From the end, no item is moved
+	while (m_qty > 0)
+	{
+		destroy(m_handleArray[m_qty - 1]);
+	}
+}
+
+/*****************************************************************************/
+void SiItemStore::reserve(const int qty)
+{
+	m_indexArray.reserve(qty);
+	m_generationArray.reserve(qty);
+	m_extraIndexArray.reserve(qty);
+	m_handlersIndexArray.reserve(qty);
+	m_freeSlotArray.reserve(qty);
+	m_handleArray.reserve(qty);
+	m_orderKeyArray.reserve(qty);
+	m_orderArray.reserve(qty);
+	m_rectArray.reserve(qty);
+	m_previousPosArray.reserve(qty);
+	m_flagArray.reserve(qty);
+	m_transformArray.reserve(qty);
+	for (auto && animArray : m_animArray)
+	{
+		animArray.reserve(qty);
+	}
+}
+
+/*****************************************************************************/
+bool SiItemStore::isValid(const SiItemHandle handle) const
+{
+	const Uint32 slot = getSlot(handle);
+
+	if (slot >= m_indexArray.size())
+	{
+		return false;
+	}
+
+	return (m_indexArray[slot] != -1) && (m_generationArray[slot] == (Uint32) (handle >> 32));
+}
+
+/*****************************************************************************/
+int SiItemStore::getQty() const
+{
+	return m_qty;
+}
+
+/*****************************************************************************/
+int SiItemStore::getIndex(const SiItemHandle handle) const
+{
+	return m_indexArray[getSlot(handle)];
+}
+
+/*****************************************************************************/
+SiItemHandle SiItemStore::getHandle(const int index) const
+{
+	return m_handleArray[index];
+}
+
+/******************************************************************************
+ Sorted again after items were destroyed out of creation order
+ *****************************************************************************/
+const std::vector<int> & SiItemStore::getOrderArray()
+{
+	if (m_isOrderDirty == true)
+	{
+		m_orderArray.resize(m_qty);
+		for (int index = 0; index < m_qty; index++)
+		{
+			m_orderArray[index] = index;
+		}
+
+		std::sort(m_orderArray.begin(), m_orderArray.end(), [this](int a, int b)
+		{
+			return m_orderKeyArray[a] < m_orderKeyArray[b];
+		});
+
+		m_isOrderDirty = false;
+	}
+
+	return m_orderArray;
+}
+
+/*****************************************************************************/
+const std::vector<SDL_Rect> & SiItemStore::getRectArray() const
+{
+	return m_rectArray;
+}
+
+/*****************************************************************************/
+SDL_Rect & SiItemStore::getRect(const int index)
+{
+	return m_rectArray[index];
+}
+
+/*****************************************************************************/
+const std::vector<SDL_Point> & SiItemStore::getPreviousPosArray() const
+{
+	return m_previousPosArray;
+}
+
+/*****************************************************************************/
+void SiItemStore::savePositions()
+{
+	for (int index = 0; index < m_qty; index++)
+	{
+		m_previousPosArray[index].x = m_rectArray[index].x;
+		m_previousPosArray[index].y = m_rectArray[index].y;
+		m_flagArray[index] &= ~FLAG_SNAP;
+	}
+}
+
+/*****************************************************************************/
+const std::vector<Uint32> & SiItemStore::getFlagArray() const
+{
+	return m_flagArray;
+}
+
+/*****************************************************************************/
+bool SiItemStore::isFlag(const int index, const Uint32 flag) const
+{
+	return (m_flagArray[index] & flag) != 0U;
+}
+
+/*****************************************************************************/
+void SiItemStore::setFlag(const int index, const Uint32 flag, const bool isSet)
+{
+	if (isSet == true)
+	{
+		m_flagArray[index] |= flag;
+	}
+	else
+	{
+		m_flagArray[index] &= ~flag;
+	}
+}
+
+/*****************************************************************************/
+const std::vector<SiItemStore::Transform> & SiItemStore::getTransformArray() const
+{
+	return m_transformArray;
+}
+
+/*****************************************************************************/
+SiItemStore::Transform & SiItemStore::getTransform(const int index)
+{
+	return m_transformArray[index];
+}
+
+/*****************************************************************************/
+const std::vector<SiAnim*> & SiItemStore::getAnim(const int index, const AnimSet set) const
+{
+	return m_animArray[static_cast<int>(set)][index];
+}
+
+/*****************************************************************************/
+std::vector<SiAnim*> & SiItemStore::getAnim(const int index, const AnimSet set)
+{
+	return m_animArray[static_cast<int>(set)][index];
+}
+
+/*****************************************************************************/
+SiItemStore::Extra & SiItemStore::getExtra(const SiItemHandle handle)
+{
+	const Uint32 slot = getSlot(handle);
+
+	if (m_extraIndexArray[slot] == -1)
+	{
+		if (m_freeExtraArray.empty() == false)
+		{
+			m_extraIndexArray[slot] = m_freeExtraArray.back();
+			m_freeExtraArray.pop_back();
+		}
+		else
+		{
+			m_extraIndexArray[slot] = m_extraPool.size();
+			m_extraPool.emplace_back();
+		}
+	}
+
+	return m_extraPool[m_extraIndexArray[slot]];
+}
+
+/*****************************************************************************/
+void SiItemStore::setText(const SiItemHandle handle, const std::string & text)
+{
+	getExtra(handle).text = text;
+	setFlag(getIndex(handle), FLAG_TEXT, text.empty() == false);
+}
+
+/*****************************************************************************/
+const SiItemStore::Extra * SiItemStore::findExtra(const SiItemHandle handle) const
+{
+	const int extraIndex = m_extraIndexArray[getSlot(handle)];
+	if (extraIndex == -1)
+	{
+		return nullptr;
+	}
+
+	return &m_extraPool[extraIndex];
+}
+
+/*****************************************************************************/
+SiItemStore::Handlers & SiItemStore::getHandlers(const SiItemHandle handle)
+{
+	const Uint32 slot = getSlot(handle);
+
+	if (m_handlersIndexArray[slot] == -1)
+	{
+		if (m_freeHandlersArray.empty() == false)
+		{
+			m_handlersIndexArray[slot] = m_freeHandlersArray.back();
+			m_freeHandlersArray.pop_back();
+		}
+		else
+		{
+			m_handlersIndexArray[slot] = m_handlersPool.size();
+			m_handlersPool.emplace_back();
+		}
+	}
+
+	return m_handlersPool[m_handlersIndexArray[slot]];
+}
+
+/*****************************************************************************/
+const SiItemStore::Handlers * SiItemStore::findHandlers(const SiItemHandle handle) const
+{
+	const int handlersIndex = m_handlersIndexArray[getSlot(handle)];
+	if (handlersIndex == -1)
+	{
+		return nullptr;
+	}
+
+	return &m_handlersPool[handlersIndex];
+}
+
+/*****************************************************************************/
+SiItemStore & SiItemStore::getDefault()
+{
+	static SiItemStore store;
+
+	return store;
+}
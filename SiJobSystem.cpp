@@ -0,0 +1,209 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "SiJobSystem.h"
+#include <algorithm>
+
+/*****************************************************************************/
+SiJobSystem::SiJobSystem(const int workerQty) :
+		m_queueArray(), m_threadArray(), m_sleepMutex(), m_condition(), m_queuedQty(0), m_isQuit(false)
+{
+	int qty = workerQty;
+	if (qty < 0)
+	{
+		// hardware_concurrency() may return 0 if unknown
+		qty = (int) std::thread::hardware_concurrency() - 1;
+		if (qty < 0)
+		{
+			qty = 0;
+		}
+	}
+
+	for (int i = 0; i < qty + 1; i++)
+	{
+		m_queueArray.emplace_back(new Queue);
+	}
+
+	for (int i = 0; i < qty; i++)
+	{
+		m_threadArray.emplace_back(&SiJobSystem::workerLoop, this, i + 1);
+	}
+}
+
+/*****************************************************************************/
+SiJobSystem::~SiJobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_isQuit = true;
+	}
+	m_condition.notify_all();
+
+	for (auto && thread : m_threadArray)
+	{
+		thread.join();
+	}
+}
+
+/*****************************************************************************/
+int SiJobSystem::getWorkerQty() const
+{
+	return m_threadArray.size();
+}
+
+/*****************************************************************************/
+int SiJobSystem::getChunkQty(const int qty, const int chunkSize)
+{
+	return (qty + chunkSize - 1) / chunkSize;
+}
+
+/*****************************************************************************/
+void SiJobSystem::parallelFor(const int qty, const int chunkSize, const std::function<void(int chunk, int begin, int end)> & job)
+{
+	const int chunkQty = getChunkQty(qty, chunkSize);
+
+	if ((m_threadArray.empty() == true) || (chunkQty <= 1))
+	{
+		for (int chunk = 0; chunk < chunkQty; chunk++)
+		{
+			job(chunk, chunk * chunkSize, std::min(qty, (chunk + 1) * chunkSize));
+		}
+		return;
+	}
+
+	Batch batch;
+	batch.job = &job;
+	batch.remainingQty = chunkQty;
+
+	// Consecutive chunks are given to each queue, stealing takes the first
+	// ones of a queue while its owner takes the last ones
+	const int queueQty = m_queueArray.size();
+	for (int queueIndex = 0; queueIndex < queueQty; queueIndex++)
+	{
+		const int firstChunk = chunkQty * queueIndex / queueQty;
+		const int lastChunk = chunkQty * (queueIndex + 1) / queueQty;
+		Queue & queue = *m_queueArray[queueIndex];
+
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		for (int chunk = firstChunk; chunk < lastChunk; chunk++)
+		{
+			queue.chunkArray.push_back(Chunk
+			{ &batch, chunk, chunk * chunkSize, std::min(qty, (chunk + 1) * chunkSize) });
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_queuedQty += chunkQty;
+	}
+	m_condition.notify_all();
+
+	Chunk chunk;
+	while (batch.remainingQty.load(std::memory_order_acquire) > 0)
+	{
+		if (popChunk(0, chunk) == true)
+		{
+			runChunk(chunk);
+		}
+		else
+		{
+			// Last chunks are running on workers
+			std::this_thread::yield();
+		}
+	}
+}
+
+/******************************************************************************
+ Take a chunk from the back of queueIndex or steal one from the front of
+ another queue
+ *****************************************************************************/
+bool SiJobSystem::popChunk(const int queueIndex, Chunk & chunk)
+{
+	const int queueQty = m_queueArray.size();
+
+	for (int i = 0; i < queueQty; i++)
+	{
+		Queue & queue = *m_queueArray[(queueIndex + i) % queueQty];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (queue.chunkArray.empty() == true)
+		{
+			continue;
+		}
+
+		if (i == 0)
+		{
+			chunk = queue.chunkArray.back();
+			queue.chunkArray.pop_back();
+		}
+		else
+		{
+			chunk = queue.chunkArray.front();
+			queue.chunkArray.pop_front();
+		}
+
+		m_queuedQty--;
+		return true;
+	}
+
+	return false;
+}
+
+/*****************************************************************************/
+void SiJobSystem::runChunk(const Chunk & chunk)
+{
+	(*chunk.batch->job)(chunk.index, chunk.begin, chunk.end);
+
+	// Last access to the batch: parallelFor may return right after
+	chunk.batch->remainingQty.fetch_sub(1, std::memory_order_release);
+}
+
+/*****************************************************************************/
+void SiJobSystem::workerLoop(const int queueIndex)
+{
+	Chunk chunk;
+
+	while (true)
+	{
+		if (popChunk(queueIndex, chunk) == true)
+		{
+			runChunk(chunk);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_condition.wait(lock, [this]()
+		{
+			return (m_isQuit == true) || (m_queuedQty.load() > 0);
+		});
+
+		if (m_isQuit == true)
+		{
+			return;
+		}
+	}
+}
+
+/*****************************************************************************/
+SiJobSystem & SiJobSystem::getDefault()
+{
+	static SiJobSystem jobSystem;
+
+	return jobSystem;
+}
@@ -0,0 +1,189 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "si_file.h"
+#include "si_frame.h"
+#include "si_pack.h"
+#include "SiAnim.h"
+#include "SiPack.h"
+#include <string.h>
+
+/*****************************************************************************/
+SiPack::SiPack() :
+		m_file(), m_format(0U), m_indexMap()
+{
+}
+
+/*****************************************************************************/
+SiPack::~SiPack()
+{
+}
+
+/*****************************************************************************/
+bool SiPack::open(const std::string & filePath)
+{
+	m_indexMap.clear();
+	m_file.reset(new FileMap);
+
+	if (m_file->open(filePath) == false)
+	{
+		return false;
+	}
+
+	const Uint8 * data = m_file->getData();
+	const size_t size = m_file->getSize();
+
+	PackHeader header;
+	if (size < sizeof(header))
+	{
+		return false;
+	}
+	memcpy(&header, data, sizeof(header));
+
+	if ((memcmp(header.magic, PACK_MAGIC, sizeof(header.magic)) != 0) || (header.version != PACK_VERSION))
+	{
+		return false;
+	}
+
+	m_format = header.format;
+
+	size_t offset = header.indexOffset;
+	for (Uint32 i = 0U; i < header.animQty; i++)
+	{
+		PackIndex index;
+		if ((offset > size) || (size - offset < sizeof(index)))
+		{
+			return false;
+		}
+		memcpy(&index, data + offset, sizeof(index));
+		offset += sizeof(index);
+
+		if (size - offset < index.nameSize)
+		{
+			return false;
+		}
+		m_indexMap[std::string((const char *) data + offset, index.nameSize)] = index.animOffset;
+		offset += index.nameSize;
+	}
+
+	return true;
+}
+
+/*****************************************************************************/
+SiAnim * SiPack::getAnim(const std::string & name) const
+{
+	auto it = m_indexMap.find(name);
+	if (it == m_indexMap.end())
+	{
+		return nullptr;
+	}
+
+	const Uint8 * data = m_file->getData();
+	const size_t size = m_file->getSize();
+	size_t offset = it->second;
+
+	PackAnim packAnim;
+	if ((offset > size) || (size - offset < sizeof(packAnim)))
+	{
+		return nullptr;
+	}
+	memcpy(&packAnim, data + offset, sizeof(packAnim));
+	offset += sizeof(packAnim);
+
+	if ((size - offset) / sizeof(PackFrame) < packAnim.frameQty)
+	{
+		return nullptr;
+	}
+
+	SiAnim * anim = new SiAnim;
+	anim->setWidth(packAnim.width);
+	anim->setHeight(packAnim.height);
+
+	Uint32 totalDuration = 0U;
+	// First frame using each pixel offset, whose texture is shared by identical frames
+	std::unordered_map<Uint64, Uint32> pixelFrameMap;
+
+	for (Uint32 i = 0U; i < packAnim.frameQty; i++)
+	{
+		PackFrame frame;
+		memcpy(&frame, data + offset + i * sizeof(frame), sizeof(frame));
+
+		// A delta frame refers to a previous full frame
+		if ((frame.keyFrame != SiAnim::NO_KEY_FRAME) && ((frame.keyFrame < 0) || (frame.keyFrame >= (Sint32) i)))
+		{
+			delete anim;
+			return nullptr;
+		}
+
+		SDL_Rect rect =
+		{ frame.x, frame.y, frame.width, frame.height };
+		SDL_Texture * tex = nullptr;
+
+		auto shared = pixelFrameMap.find(frame.pixelOffset);
+		if ((frame.pixelOffset != 0U) && (shared != pixelFrameMap.end()))
+		{
+			PackFrame sharedFrame;
+			memcpy(&sharedFrame, data + offset + shared->second * sizeof(sharedFrame), sizeof(sharedFrame));
+
+			if ((sharedFrame.x == frame.x) && (sharedFrame.y == frame.y) && (sharedFrame.width == frame.width) && (sharedFrame.height == frame.height)
+					&& (sharedFrame.keyFrame == frame.keyFrame))
+			{
+				anim->pushFrameCopy(shared->second);
+				anim->pushDelay(frame.delay);
+				totalDuration += frame.delay;
+				continue;
+			}
+		}
+
+		if (frame.pixelOffset != 0U)
+		{
+			const Uint64 pixelSize = (Uint64) frame.width * frame.height * 4U;
+			if ((frame.pixelOffset > size) || (size - frame.pixelOffset < pixelSize))
+			{
+				delete anim;
+				return nullptr;
+			}
+
+			// Pixels are uploaded from the mapping, without intermediate copy
+			tex = frame_create_texture(m_format, data + frame.pixelOffset, frame.width * 4, frame.width, frame.height, TextureOrigin::PACK);
+			pixelFrameMap.emplace(frame.pixelOffset, i);
+		}
+
+		anim->pushTexture(tex, rect, frame.keyFrame);
+		anim->pushDelay(frame.delay);
+		totalDuration += frame.delay;
+	}
+
+	anim->setTotalDuration(totalDuration);
+
+	return anim;
+}
+
+/*****************************************************************************/
+std::vector<std::string> SiPack::getNameArray() const
+{
+	std::vector<std::string> nameArray;
+
+	for (auto && index : m_indexMap)
+	{
+		nameArray.push_back(index.first);
+	}
+
+	return nameArray;
+}
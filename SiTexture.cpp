@@ -17,26 +17,170 @@
  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
  */
 
+#include "sdl.h"
+#include "si_frame.h"
+#include "tracker.h"
 #include <SDL.h>
 #include <SiTexture.h>
 
 /*****************************************************************************/
 SiTexture::SiTexture(SDL_Texture * texture) :
-		m_texture(texture)
+		m_texture(texture), m_surface(nullptr), m_context(nullptr), m_lastUseTick(0U)
 {
 }
 
 /*****************************************************************************/
+SiTexture::SiTexture(SDL_Surface * surface) :
+		m_texture(nullptr), m_surface(surface), m_context(nullptr), m_lastUseTick(0U)
+{
+}
+
+/******************************************************************************
+ The last reference may be dropped by any thread: a texture created from the
+ surface is handed to its context, which destroys it in sdl_loop_manager()
+ *****************************************************************************/
 SiTexture::~SiTexture()
 {
-	if (m_texture != nullptr)
+	if (m_surface != nullptr)
+	{
+		SdlItemContext * owner = m_context.load(std::memory_order_acquire);
+
+		// The owner may release the texture before its lock is taken
+		while (owner != nullptr)
+		{
+			SdlItemContext::State & state = owner->getState();
+			std::lock_guard<std::mutex> lock(state.lazyTextureMutex);
+
+			if (m_context.load(std::memory_order_acquire) == owner)
+			{
+				state.lazyTextureSet.erase(this);
+				state.textureReleaseArray.push_back(m_texture);
+				break;
+			}
+
+			owner = m_context.load(std::memory_order_acquire);
+		}
+
+		SDL_FreeSurface(m_surface);
+	}
+	else if (m_texture != nullptr)
 	{
-		SDL_DestroyTexture(m_texture);
+		tracker_destroy_texture(m_texture);
 	}
 }
 
-/*****************************************************************************/
+/******************************************************************************
+ A texture created from a surface belongs to the renderer of the current
+ context. It is not drawn by other contexts until this one released it.
+ Only its creation takes the lock of the context.
+ *****************************************************************************/
 SDL_Texture* SiTexture::getTexture()
 {
+	if (m_surface == nullptr)
+	{
+		return m_texture;
+	}
+
+	SdlItemContext & context = sdl_get_context();
+	SdlItemContext * owner = m_context.load(std::memory_order_acquire);
+
+	if (owner == nullptr)
+	{
+		SdlItemContext::State & state = context.getState();
+		std::lock_guard<std::mutex> lock(state.lazyTextureMutex);
+
+		if (m_context.compare_exchange_strong(owner, &context, std::memory_order_acq_rel) == false)
+		{
+			return nullptr;
+		}
+
+		SDL_Rect rect =
+		{ 0, 0, m_surface->w, m_surface->h };
+		m_texture = frame_create_texture(m_surface, rect);
+		if (m_texture == nullptr)
+		{
+			m_context.store(nullptr, std::memory_order_release);
+			return nullptr;
+		}
+		state.lazyTextureSet.insert(this);
+	}
+	else if (owner != &context)
+	{
+		return nullptr;
+	}
+
+	m_lastUseTick = sdl_get_global_time();
+
 	return m_texture;
 }
+
+/*****************************************************************************/
+SDL_Surface* SiTexture::getSurface()
+{
+	return m_surface;
+}
+
+/******************************************************************************
+ Called by the thread of the owner context, with its lazyTextureMutex locked
+ *****************************************************************************/
+void SiTexture::release()
+{
+	tracker_destroy_texture(m_texture);
+	m_texture = nullptr;
+
+	m_context.load(std::memory_order_relaxed)->getState().lazyTextureSet.erase(this);
+	m_context.store(nullptr, std::memory_order_release);
+}
+
+/******************************************************************************
+ Textures of the lazy textures destroyed by any thread since the last call are
+ destroyed in any case
+ *****************************************************************************/
+void SiTexture::releaseUnused(SdlItemContext & context, const Uint32 now, const Uint32 delay)
+{
+	SdlItemContext::State & state = context.getState();
+	std::lock_guard<std::mutex> lock(state.lazyTextureMutex);
+
+	for (SDL_Texture * texture : state.textureReleaseArray)
+	{
+		tracker_destroy_texture(texture);
+	}
+	state.textureReleaseArray.clear();
+
+	if (delay == 0U)
+	{
+		return;
+	}
+
+	auto it = state.lazyTextureSet.begin();
+	while (it != state.lazyTextureSet.end())
+	{
+		SiTexture * texture = *it;
+
+		// texture is removed from lazyTextureSet
+		it++;
+
+		if (now - texture->m_lastUseTick >= delay)
+		{
+			texture->release();
+		}
+	}
+}
+
+/*****************************************************************************/
+void SiTexture::releaseAll(SdlItemContext & context)
+{
+	SdlItemContext::State & state = context.getState();
+	std::lock_guard<std::mutex> lock(state.lazyTextureMutex);
+
+	for (SDL_Texture * texture : state.textureReleaseArray)
+	{
+		tracker_destroy_texture(texture);
+	}
+	state.textureReleaseArray.clear();
+
+	while (state.lazyTextureSet.empty() == false)
+	{
+		(*state.lazyTextureSet.begin())->release();
+	}
+}
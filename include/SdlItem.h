@@ -23,9 +23,12 @@
 #include <functional>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL.h>
+#include "SiItemStore.h"
 #include <string>
 #include <vector>
 
+// View over an item of a SiItemStore. The item is created with the view and
+// destroyed with it, copying the view copies the item.
 class SdlItem
 {
 public:
@@ -34,9 +37,18 @@ public:
 		TOP_LEFT, CENTER
 	};
 
+	// Item of SiItemStore::getDefault()
 	SdlItem();
+	explicit SdlItem(SiItemStore & store);
+	SdlItem(const SdlItem & item);
+	SdlItem(SdlItem && item) noexcept;
+	SdlItem & operator=(const SdlItem & item);
+	SdlItem & operator=(SdlItem && item) noexcept;
 	virtual ~SdlItem();
 
+	SiItemStore & getStore() const;
+	SiItemHandle getHandle() const;
+
 	void setPos(const int x, const int y);
 	void setShape(const int width, const int height);
 
@@ -147,40 +159,10 @@ public:
 	void setClicked(bool clicked);
 
 private:
-	SDL_Rect m_rect; // Current coordinate/size in pixels
-	Uint32 m_animStartTick;	// Tick from when animation will be calculated
-	SDL_RendererFlip m_flip;
-	double m_angle;
-	double m_zoomX;
-	double m_zoomY;
-	int m_user1;	// User defined
-	int m_user2;	// User defined
-	bool m_overlay;
-	std::vector<SiAnim*> m_animArray;         //default sprite
-	std::vector<SiAnim*> m_animOver;  //is set to default_anim_over, when needed (i.e. mouse over this item)
-	std::vector<SiAnim*> m_defaultAnimOver;
-	std::vector<SiAnim*> m_animClick; //is set to default_anim_click, when needed (i.e. click on this item)
-	std::vector<SiAnim*> m_defaultAnimClick;
-
-	Layout m_layout;	// How to display array of anim (default is top-left)
-	bool m_animLoop;
-	bool m_clicked;
-	std::function<void()> m_clickLeftCb;
-	std::function<void()> m_clickRightCb;
-	std::function<void()> m_doubleClickLeftCb;
-	std::function<void()> m_doubleClickRightCb;
-	std::function<void()> m_wheelUpCb;
-	std::function<void()> m_wheelDownCb;
-	std::function<void(int x, int y)> m_overCb;
-	std::string m_text;		// string centered on item
-	Uint32 m_backGroudColor;	// Background color RGBA
-	TTF_Font * m_font;
-	SDL_Texture * m_textTexture;
-	bool m_editable;
-	std::function<void(std::string)> m_editCb;
-
-	const void * m_userPtr;
-	std::string m_userString;
+	int getIndex() const;
+
+	SiItemStore * m_store;
+	SiItemHandle m_handle;
 };
 
 #endif /* SDL_ITEM_SDLITEM_H_ */
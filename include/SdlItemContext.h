@@ -0,0 +1,111 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef SDL_ITEM_CONTEXT_H_
+#define SDL_ITEM_CONTEXT_H_
+
+#include "SiCamera.h"
+#include "SiCommandQueue.h"
+#include "SiItemStore.h"
+#include "SiKeyCallback.h"
+#include "SiMouseEvent.h"
+#include <functional>
+#include <mutex>
+#include <SDL2/SDL.h>
+#include <unordered_set>
+#include <vector>
+
+class SiTexture;
+
+// Window, renderer, cameras, input and callback state of the sdl_* functions.
+// Contexts are independent: each one may have its own window and renderer,
+// or none for headless use. The sdl_* functions use the current context of
+// the calling thread, the default one unless sdl_set_context() was called.
+class SdlItemContext
+{
+public:
+	// Read and written by the sdl_* functions
+	struct State
+	{
+		SDL_Window * window = nullptr;
+		SDL_Renderer * renderer = nullptr;
+		int fullscreen = 0;
+
+		// Editable item receiving keyboard text
+		SiItemStore * focusedStore = nullptr;
+		SiItemHandle focusedItem = SiItemStore::NO_ITEM;
+		Uint32 wheelTimeStamp = 0U;
+
+		// Camera of the sdl_* functions without camera parameter
+		SiCamera camera;
+		// Cameras moved by sdl_loop_manager() besides the default one
+		std::vector<SiCamera *> cameraArray;
+		bool isPixelSnap = false;
+
+		int mouseX = 0;
+		int mouseY = 0;
+		bool isAppHasFocus = false;
+		Uint32 globalTick = 0U;
+		Uint32 oldTimer = 0U;
+
+		std::vector<SiKeyCallback> keyCbArray;
+		std::vector<SiMouseEvent> mouseEventArray;
+
+		// Lazy textures created by this context, see SiTexture. The mutex guards
+		// the set and the release array against the destruction of lazy textures
+		// by other threads, drawing an already created texture does not take it.
+		std::mutex lazyTextureMutex;
+		std::unordered_set<SiTexture *> lazyTextureSet;
+		// Textures of the lazy textures destroyed since the last release
+		std::vector<SDL_Texture *> textureReleaseArray;
+		// Lazy textures not drawn for textureReleaseDelay ms are released, 0 to keep them
+		Uint32 textureReleaseDelay = 10000U;
+		Uint32 textureReleaseTick = 0U;
+
+		// Fixed time step, disabled if stepRate is 0
+		int stepRate = 0; // steps per second
+		int maxStepQty = 0; // per frame, late steps beyond it are dropped
+		std::function<void()> stepCb;
+		std::vector<SiItemStore *> stepStoreArray; // items interpolated between steps
+		Uint64 stepCounter = 0U; // performance counter of the last frame
+		double stepLag = 0.0; // seconds not simulated yet
+		double stepAlpha = 1.0;
+	};
+
+	SdlItemContext();
+	SdlItemContext(const SdlItemContext &) = delete;
+	SdlItemContext & operator=(const SdlItemContext &) = delete;
+	// Destroy the window and renderer created by sdl_init()
+	virtual ~SdlItemContext();
+
+	State & getState();
+	// Commands of other threads, applied by sdl_loop_manager()
+	SiCommandQueue & getCommandQueue();
+	SDL_Window * getWindow() const;
+	SDL_Renderer * getRenderer() const;
+
+	// Context of the threads which did not call sdl_set_context()
+	static SdlItemContext & getDefault();
+
+private:
+	State m_state;
+	SiCommandQueue m_commandQueue;
+};
+
+#endif /* SDL_ITEM_CONTEXT_H_ */
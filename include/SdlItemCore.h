@@ -22,7 +22,12 @@
 
 #include "sdl.h"
 #include "SdlItem.h"
+#include "SdlItemContext.h"
 #include "SiAnim.h"
+#include "SiCamera.h"
+#include "SiCommandQueue.h"
+#include "SiItemStore.h"
+#include "SiJobSystem.h"
 #include "SiKeyCallback.h"
 #include "SiMouseEvent.h"
 
@@ -22,12 +22,27 @@
 
 #include <memory>
 #include <SDL.h>
+#include <SiStream.h>
 #include <SiTexture.h>
 #include <vector>
 
 class SiAnim
 {
 public:
+	// Key frame index of a frame which is not a delta frame
+	static constexpr int NO_KEY_FRAME = -1;
+
+	// What is read to draw a frame, stored contiguously for all frames.
+	// The delay is not part of it: the current frame is found by scanning
+	// the delays of all frames, which getDelayArray() keeps 16 to a cache line.
+	struct Frame
+	{
+		SiTexture * texture; // owned by getTextureArray(), may be shared with other frames
+		SDL_Rect source; // Area of the texture to draw
+		SDL_Rect rect; // Area of the anim covered by the texture
+		int keyFrame; // Frame drawn under delta frames, NO_KEY_FRAME otherwise
+	};
+
 	SiAnim();
 	virtual ~SiAnim();
 
@@ -39,7 +54,28 @@ public:
 
 	const std::vector<std::shared_ptr<SiTexture>>& getTextureArray() const;
 	void pushTexture(SDL_Texture*);
-	std::shared_ptr<SiTexture> getTexture(const int index) const;
+	void pushTexture(SDL_Texture* texture, const SDL_Rect & rect, const int keyFrame);
+	// Frame kept in CPU memory, its texture is created when it is drawn.
+	// The anim takes ownership of surface
+	void pushSurface(SDL_Surface* surface, const SDL_Rect & rect, const int keyFrame);
+	// Frame drawn from the source area of a texture shared with other frames (sprite sheet)
+	void pushTextureArea(const std::shared_ptr<SiTexture> & texture, const SDL_Rect & source, const SDL_Rect & rect);
+	// Push a frame sharing the texture of frame index, in the anim and its levels
+	void pushFrameCopy(const int index);
+	// Push a frame drawing nothing, in the anim and its levels. Keeps the
+	// frame indexes of a file whose frame could not be decoded.
+	void pushEmptyFrame();
+	// Replace each run of identical adjacent frames by one frame lasting
+	// the sum of their delays. Frame indexes change.
+	void mergeRepeatedFrames();
+	const std::shared_ptr<SiTexture> & getTexture(const int index) const;
+	// Borrowed reference for the render path, without reference counting.
+	// Valid until a frame is pushed or frames are merged.
+	const Frame & getFrame(const int index) const;
+
+	const SDL_Rect & getSourceRect(const int index) const;
+	const SDL_Rect & getFrameRect(const int index) const;
+	int getKeyFrame(const int index) const;
 
 	Uint32 getTotalDuration() const;
 	void setTotalDuration(Uint32 totalDuration);
@@ -50,12 +86,33 @@ public:
 	void setDelayArray(const std::vector<Uint32>& delayArray);
 	void pushDelay(const Uint32 delay);
 
+	const std::shared_ptr<SiStream>& getStream() const;
+	void setStream(const std::shared_ptr<SiStream>& stream);
+
+	// Level 0 is half the size of the anim, each next level half the previous one.
+	// Levels have the same frames as the anim, without delay.
+	int getLevelQty() const;
+	const SiAnim & getLevel(const int index) const;
+	SiAnim & getLevel(const int index);
+	// The anim takes ownership of level
+	void pushLevel(SiAnim * level);
+	// Level fitting a display scale, the anim itself if scale is above 0.5
+	const SiAnim & getLevelForScale(const double scale) const;
+
 private:
-	std::vector<std::shared_ptr<SiTexture>> m_textureArray;
+	void pushFrame(const std::shared_ptr<SiTexture> & texture, const SDL_Rect & source, const SDL_Rect & rect, const int keyFrame);
+	bool isSameFrame(const int first, const int second) const;
+	// Keep the first frame mapped to each new index, newIndexArray having one entry per frame
+	void compactFrames(const std::vector<int> & newIndexArray, const int newQty);
+
+	std::vector<Frame> m_frameArray;
+	std::vector<std::shared_ptr<SiTexture>> m_textureArray; // owner of each frame's texture, not read when drawing
 	int m_width;
 	int m_height;
-	std::vector<Uint32> m_delayArray; //delay between each frame in millisecond
+	std::vector<Uint32> m_delayArray; //delay between each frame in millisecond, scanned by each draw
 	Uint32 m_totalDuration;
+	std::shared_ptr<SiStream> m_stream; // Frames decoded on the fly instead of m_textureArray
+	std::vector<std::unique_ptr<SiAnim>> m_levelArray; // Mipmap levels
 };
 
 #endif /* SDL_ITEM_ANIM_H_ */
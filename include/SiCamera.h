@@ -0,0 +1,79 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef SDL_ITEM_CAMERA_H_
+#define SDL_ITEM_CAMERA_H_
+
+#include <SDL2/SDL.h>
+
+// Position and zoom of a view on the items, drawn in a viewport of the
+// renderer output. Moves are interpolated by sdl_loop_manager() for the
+// cameras added to the context with sdl_add_camera().
+class SiCamera
+{
+public:
+	SiCamera();
+	virtual ~SiCamera();
+
+	// Area of the renderer output, empty for the whole output without clipping
+	const SDL_Rect & getViewport() const;
+	void setViewport(const SDL_Rect & viewport);
+
+	// Position and zoom the camera moves to from tick
+	double getX() const;
+	void setX(const double x, const Uint32 tick);
+	double getY() const;
+	void setY(const double y, const Uint32 tick);
+	double getZoom() const;
+	void setZoom(const double zoom, const Uint32 tick);
+	// Without interpolation
+	void forceX(const double x);
+	void forceY(const double y);
+	void forceZoom(const double zoom);
+
+	// Position and zoom drawn with
+	double getCurrentX() const;
+	double getCurrentY() const;
+	double getCurrentZoom() const;
+
+	// Interpolate over wall-clock time
+	void update(const Uint32 tick);
+	// Interpolate between fixed time steps: saveStep() before each step,
+	// then interpolateStep() with the elapsed part of the next one
+	void saveStep();
+	void interpolateStep(const double alpha);
+
+private:
+	SDL_Rect m_viewport;
+	double m_x;
+	double m_y;
+	double m_zoom;
+	double m_oldX; // current values when the move started
+	double m_oldY;
+	double m_oldZoom;
+	double m_currentX;
+	double m_currentY;
+	double m_currentZoom;
+	Uint32 m_moveTick;
+	double m_stepX; // values at the previous step
+	double m_stepY;
+	double m_stepZoom;
+};
+
+#endif /* SDL_ITEM_CAMERA_H_ */
@@ -0,0 +1,83 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef SDL_ITEM_COMMAND_QUEUE_H_
+#define SDL_ITEM_COMMAND_QUEUE_H_
+
+#include "SiItemStore.h"
+#include <atomic>
+#include <SDL2/SDL.h>
+#include <string>
+
+class SiAnim;
+
+// Item and camera changes pushed by any thread and applied by the render
+// thread at the start of sdl_loop_manager(). Commands are linked in a
+// lock-free list with multiple producers and a single consumer, so pushing
+// never waits for the frame being drawn.
+class SiCommandQueue
+{
+public:
+	enum class Type
+	{
+		POSITION, ANIM, TEXT, CAMERA
+	};
+
+	struct Command
+	{
+		Type type = Type::POSITION;
+		SiItemStore * store = nullptr;
+		SiItemHandle handle = SiItemStore::NO_ITEM; // ignored if destroyed when applied
+		int x = 0; // POSITION and CAMERA
+		int y = 0;
+		double z = 1.0; // CAMERA
+		SiAnim * anim = nullptr;
+		std::string text;
+	};
+
+	SiCommandQueue();
+	SiCommandQueue(const SiCommandQueue &) = delete;
+	SiCommandQueue & operator=(const SiCommandQueue &) = delete;
+	virtual ~SiCommandQueue();
+
+	// Any thread
+	void pushPosition(SiItemStore & store, const SiItemHandle handle, const int x, const int y);
+	// Ignored if anim is nullptr
+	void pushAnim(SiItemStore & store, const SiItemHandle handle, SiAnim * anim);
+	void pushText(SiItemStore & store, const SiItemHandle handle, const std::string & text);
+	void pushCamera(const int x, const int y, const double z);
+
+	// Consumer thread only, return false if there is no command. A command
+	// whose push is not finished is returned by a later call.
+	bool pop(Command & command);
+
+private:
+	struct Node
+	{
+		std::atomic<Node *> next;
+		Command command;
+	};
+
+	void push(Node * node);
+
+	std::atomic<Node *> m_head; // last pushed node
+	Node * m_tail; // node before the next one to pop, already popped
+};
+
+#endif /* SDL_ITEM_COMMAND_QUEUE_H_ */
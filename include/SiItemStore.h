@@ -0,0 +1,199 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef SDL_ITEM_STORE_H_
+#define SDL_ITEM_STORE_H_
+
+#include <functional>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+class SiAnim;
+
+// Identify an item of a SiItemStore. Low 32 bits are a slot, high 32 bits the
+// generation of the slot: handles of destroyed items are detected as invalid
+// even after their slot is reused.
+typedef Uint64 SiItemHandle;
+
+// Items stored as a structure of arrays. What the blit and mouse loops read
+// for every item is kept in dense arrays indexed from 0 to getQty() - 1,
+// callbacks and text are in side tables only filled for items using them.
+// Entries of destroyed items are recycled with the capacity of their vectors
+// and strings, so that creating as many items as were destroyed does not
+// allocate memory.
+class SiItemStore
+{
+public:
+	static constexpr SiItemHandle NO_ITEM = 0xFFFFFFFFFFFFFFFFULL;
+
+	// Bits of the flag array
+	static constexpr Uint32 FLAG_OVERLAY = 0x01U;
+	static constexpr Uint32 FLAG_ANIM_LOOP = 0x02U;
+	static constexpr Uint32 FLAG_CLICKED = 0x04U;
+	static constexpr Uint32 FLAG_EDITABLE = 0x08U;
+	static constexpr Uint32 FLAG_LAYOUT_CENTER = 0x10U;
+	static constexpr Uint32 FLAG_TEXT = 0x20U; // the item has a text in its extra data
+	// Drawn at its current position instead of being interpolated from its
+	// previous one, until savePositions() is called. Set on creation.
+	static constexpr Uint32 FLAG_SNAP = 0x40U;
+	// Bits of the flag array telling which handlers are set, checked
+	// before looking for the handlers
+	static constexpr Uint32 HANDLER_CLICK_LEFT = 0x0100U;
+	static constexpr Uint32 HANDLER_CLICK_RIGHT = 0x0200U;
+	static constexpr Uint32 HANDLER_DOUBLE_CLICK_LEFT = 0x0400U;
+	static constexpr Uint32 HANDLER_DOUBLE_CLICK_RIGHT = 0x0800U;
+	static constexpr Uint32 HANDLER_WHEEL_UP = 0x1000U;
+	static constexpr Uint32 HANDLER_WHEEL_DOWN = 0x2000U;
+	static constexpr Uint32 HANDLER_OVER = 0x4000U;
+	static constexpr Uint32 HANDLER_EDIT = 0x8000U;
+
+	enum class AnimSet
+	{
+		DEFAULT, // default sprite
+		OVER, // is set to DEFAULT_OVER, when needed (i.e. mouse over this item)
+		DEFAULT_OVER,
+		CLICK, // is set to DEFAULT_CLICK, when needed (i.e. click on this item)
+		DEFAULT_CLICK,
+		QTY
+	};
+
+	struct Transform
+	{
+		double angle = 0.0;
+		double zoomX = 1.0;
+		double zoomY = 1.0;
+		SDL_RendererFlip flip = SDL_FLIP_NONE;
+		Uint32 animStartTick = 0U; // Tick from when animation will be calculated
+	};
+
+	// Event handlers, only allocated for items with at least one
+	struct Handlers
+	{
+		std::function<void()> clickLeftCb;
+		std::function<void()> clickRightCb;
+		std::function<void()> doubleClickLeftCb;
+		std::function<void()> doubleClickRightCb;
+		std::function<void()> wheelUpCb;
+		std::function<void()> wheelDownCb;
+		std::function<void(int x, int y)> overCb;
+		std::function<void(std::string)> editCb;
+	};
+
+	// Data most items do not use
+	struct Extra
+	{
+		std::string text; // string centered on item
+		Uint32 backGroudColor = 0U; // Background color RGBA
+		TTF_Font * font = nullptr;
+		SDL_Texture * textTexture = nullptr;
+		int user1 = 0; // User defined
+		int user2 = 0; // User defined
+		const void * userPtr = nullptr;
+		std::string userString;
+	};
+
+	SiItemStore();
+	virtual ~SiItemStore();
+	SiItemStore(const SiItemStore &) = delete;
+	SiItemStore & operator=(const SiItemStore &) = delete;
+
+	SiItemHandle create();
+	// New item with the data of handle, except its text texture
+	SiItemHandle clone(const SiItemHandle handle);
+	// The last item is moved to the index of the destroyed one
+	void destroy(const SiItemHandle handle);
+	// Destroy all items, keeping their entries for next ones
+	void clear();
+	// Allocate entries for qty items
+	void reserve(const int qty);
+	// return false if the item of handle was destroyed
+	bool isValid(const SiItemHandle handle) const;
+
+	int getQty() const;
+	int getIndex(const SiItemHandle handle) const;
+	SiItemHandle getHandle(const int index) const;
+
+	// Indexes of the items in creation order, which is their drawing and
+	// clicking order. Valid until an item is created or destroyed.
+	const std::vector<int> & getOrderArray();
+
+	// Arrays may hold recycled entries after the first getQty() ones
+	const std::vector<SDL_Rect> & getRectArray() const;
+	SDL_Rect & getRect(const int index);
+
+	// Position of the items when savePositions() was last called, to
+	// interpolate them between two fixed time steps
+	const std::vector<SDL_Point> & getPreviousPosArray() const;
+	void savePositions();
+
+	const std::vector<Uint32> & getFlagArray() const;
+	bool isFlag(const int index, const Uint32 flag) const;
+	void setFlag(const int index, const Uint32 flag, const bool isSet);
+
+	const std::vector<Transform> & getTransformArray() const;
+	Transform & getTransform(const int index);
+
+	const std::vector<SiAnim*> & getAnim(const int index, const AnimSet set) const;
+	std::vector<SiAnim*> & getAnim(const int index, const AnimSet set);
+
+	// Created by the first call. The reference is valid until extra data
+	// is created for another item.
+	Extra & getExtra(const SiItemHandle handle);
+	// Also update FLAG_TEXT
+	void setText(const SiItemHandle handle, const std::string & text);
+	// return nullptr if the item has no extra data
+	const Extra * findExtra(const SiItemHandle handle) const;
+
+	// Created by the first call, same validity as getExtra().
+	// A handler is only called if its HANDLER_* flag is set.
+	Handlers & getHandlers(const SiItemHandle handle);
+	// return nullptr if the item has no handler
+	const Handlers * findHandlers(const SiItemHandle handle) const;
+
+	// Store of the items created by SdlItem's default constructor
+	static SiItemStore & getDefault();
+
+private:
+	static Uint32 getSlot(const SiItemHandle handle);
+
+	int m_qty;
+	std::vector<int> m_indexArray; // slot to index, -1 if the slot is free
+	std::vector<Uint32> m_generationArray; // current generation of each slot
+	std::vector<int> m_extraIndexArray; // slot to m_extraPool index, -1 if none
+	std::vector<int> m_handlersIndexArray; // slot to m_handlersPool index, -1 if none
+	std::vector<Uint32> m_freeSlotArray;
+	std::vector<SiItemHandle> m_handleArray; // index to handle
+	std::vector<Uint64> m_orderKeyArray; // creation order of each index
+	Uint64 m_nextOrderKey;
+	std::vector<int> m_orderArray; // indexes sorted by order key
+	bool m_isOrderDirty; // m_orderArray must be sorted again
+	std::vector<SDL_Rect> m_rectArray; // Current coordinate/size in pixels
+	std::vector<SDL_Point> m_previousPosArray;
+	std::vector<Uint32> m_flagArray;
+	std::vector<Transform> m_transformArray;
+	std::vector<std::vector<SiAnim*>> m_animArray[static_cast<int>(AnimSet::QTY)];
+	std::vector<Extra> m_extraPool;
+	std::vector<int> m_freeExtraArray; // unused m_extraPool entries
+	std::vector<Handlers> m_handlersPool;
+	std::vector<int> m_freeHandlersArray; // unused m_handlersPool entries
+};
+
+#endif /* SDL_ITEM_STORE_H_ */
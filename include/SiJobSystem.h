@@ -0,0 +1,90 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef SDL_ITEM_JOB_SYSTEM_H_
+#define SDL_ITEM_JOB_SYSTEM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads running the chunks of a parallel loop. Each thread owns a
+// queue of chunks, idle threads steal chunks from the others so that uneven
+// chunks keep all cores busy. The calling thread runs chunks too and returns
+// when all of them are done.
+class SiJobSystem
+{
+public:
+	// workerQty threads besides the calling one, -1 for one per extra core
+	explicit SiJobSystem(const int workerQty = -1);
+	SiJobSystem(const SiJobSystem &) = delete;
+	SiJobSystem & operator=(const SiJobSystem &) = delete;
+	~SiJobSystem();
+
+	int getWorkerQty() const;
+	// Split [0, qty) in chunkSize ranges, job(chunk, begin, end) is called
+	// once for each. Chunks are run in any order on any thread. Run inline
+	// without worker thread or with a single chunk.
+	// Not to be called from a job.
+	void parallelFor(const int qty, const int chunkSize, const std::function<void(int chunk, int begin, int end)> & job);
+	static int getChunkQty(const int qty, const int chunkSize);
+
+	// Used by the library, created with the first call
+	static SiJobSystem & getDefault();
+
+private:
+	struct Batch
+	{
+		const std::function<void(int chunk, int begin, int end)> * job;
+		std::atomic<int> remainingQty;
+	};
+
+	struct Chunk
+	{
+		Batch * batch;
+		int index;
+		int begin;
+		int end;
+	};
+
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Chunk> chunkArray;
+	};
+
+	void workerLoop(const int queueIndex);
+	bool popChunk(const int queueIndex, Chunk & chunk);
+	void runChunk(const Chunk & chunk);
+
+	// Queue 0 belongs to the thread calling parallelFor, next ones to workers
+	std::vector<std::unique_ptr<Queue>> m_queueArray;
+	std::vector<std::thread> m_threadArray;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_condition;
+	std::atomic<int> m_queuedQty; // chunks in all queues
+	bool m_isQuit;
+};
+
+#endif /* SDL_ITEM_JOB_SYSTEM_H_ */
@@ -0,0 +1,53 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef SDL_ITEM_PACK_H_
+#define SDL_ITEM_PACK_H_
+
+#include <memory>
+#include <SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class FileMap;
+class SiAnim;
+
+// Anims decoded ahead of time by sdl_item_pack. Frames are uploaded to
+// textures straight from the memory mapped pack file.
+class SiPack
+{
+public:
+	SiPack();
+	virtual ~SiPack();
+
+	// return false if error
+	bool open(const std::string & filePath);
+	// return nullptr if name is not in the pack.
+	// The returned anim is owned by the caller.
+	SiAnim * getAnim(const std::string & name) const;
+	std::vector<std::string> getNameArray() const;
+
+private:
+	std::unique_ptr<FileMap> m_file;
+	Uint32 m_format;
+	std::unordered_map<std::string, size_t> m_indexMap; // anim name to offset in file
+};
+
+#endif /* SDL_ITEM_PACK_H_ */
@@ -0,0 +1,46 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef SDL_ITEM_STREAM_H_
+#define SDL_ITEM_STREAM_H_
+
+#include <SDL.h>
+
+// Anim whose frames are decoded while it is played
+class SiStream
+{
+public:
+	virtual ~SiStream()
+	{
+	}
+
+	// Return the texture to display at current global time. Playback starts
+	// at startTick of the first call, one stream has a single play position
+	// whichever item displays it.
+	virtual SDL_Texture * getTexture(const Uint32 startTick, const bool isLoop) = 0;
+
+	virtual void pause() = 0;
+	virtual void resume() = 0;
+	virtual bool isPaused() const = 0;
+
+	// Play again from the first frame
+	virtual void rewind() = 0;
+};
+
+#endif /* SDL_ITEM_STREAM_H_ */
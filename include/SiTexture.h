@@ -20,18 +20,39 @@
 #ifndef SDL_ITEM_TEXTURE_H_
 #define SDL_ITEM_TEXTURE_H_
 
-struct SDL_Texture;
+#include <atomic>
+#include <SDL.h>
+
+class SdlItemContext;
 
 class SiTexture
 {
 public:
 	SiTexture(SDL_Texture * texture);
+	// Frame pixels kept in CPU memory, the texture is created by getTexture()
+	// with the renderer of the current context. Until it is released, other
+	// contexts get nullptr. It may be destroyed by any thread, its texture is
+	// then destroyed by the owner context.
+	SiTexture(SDL_Surface * surface);
 	virtual ~SiTexture();
 
 	SDL_Texture* getTexture();
+	SDL_Surface* getSurface();
+
+	// Destroy textures created from a surface by context which were not used
+	// since delay milliseconds, none if delay is 0. They are created again by
+	// getTexture(). Also destroy the textures of destroyed lazy textures.
+	static void releaseUnused(SdlItemContext & context, const Uint32 now, const Uint32 delay);
+	// Destroy all textures created from a surface by context
+	static void releaseAll(SdlItemContext & context);
 
 private:
+	void release();
+
 	SDL_Texture * m_texture;
+	SDL_Surface * m_surface;
+	std::atomic<SdlItemContext *> m_context; // owner of a texture created from m_surface
+	Uint32 m_lastUseTick;
 };
 
 #endif /* SDL_ITEM_TEXTURE_H_ */
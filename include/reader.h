@@ -20,12 +20,70 @@
 #ifndef MEDIA_READER_H
 #define MEDIA_READER_H
 
+#include <functional>
 #include <SDL.h>
 #include <string>
 
 class SiAnim;
 
+// Processing applied to frames while they are loaded
+struct SiLoadOption
+{
+	// Size of the loaded anim in pixels. If only one is set, aspect ratio is kept.
+	int width = 0;
+	int height = 0;
+	// Used if neither width nor height is set
+	double scale = 1.0;
+	// Frames are only kept in CPU memory, no renderer is needed (see sdl_item_pack)
+	bool isNoTexture = false;
+	// Frames are kept in CPU memory, their texture is created the first time
+	// they are drawn and released when not drawn for a while
+	// (see sdl_set_texture_release_delay). Not used for videos.
+	bool isLazyTexture = false;
+	// Half size levels are generated to draw the anim zoomed out
+	bool isMipmap = false;
+	// Frames are cropped to their non transparent pixels, which are drawn at
+	// their place in the anim. The anim size is unchanged. Not used for videos.
+	bool isTrim = false;
+	// Identical adjacent frames are merged into one frame lasting the sum
+	// of their delays (see SiAnim::mergeRepeatedFrames). Frame indexes change.
+	bool isMergeFrames = false;
+	// Called on the loading thread each time a GIF frame was pushed, before
+	// the next one is decoded. anim is not complete and its total duration
+	// is not set yet: drawn from the callback, it shows its first frame while
+	// the rest of the file is loading.
+	std::function<void(const SiAnim & anim, int frameIndex)> frameCb;
+};
+
+// PNG sprite sheet whose frames are the cells of a grid,
+// read left to right then top to bottom
+struct SiSheetGrid
+{
+	int frameWidth = 0;
+	int frameHeight = 0;
+	// 0 for all the cells of the sheet
+	int frameQty = 0;
+	// Pixels around the grid and between cells
+	int margin = 0;
+	int spacing = 0;
+	Uint32 delay = 100U;
+};
+
 SiAnim * anim_load(const std::string & filePath);
+// Frames are only shrunk, never enlarged
+SiAnim * anim_load(const std::string & filePath, const SiLoadOption & option);
+// Video decoded while it is played, with constant memory usage
+SiAnim * anim_load_stream(const std::string & filePath);
+SiAnim * anim_load_stream(const std::string & filePath, const SiLoadOption & option);
+// All frames of a sprite sheet share one texture. Sheets are not scaled and
+// have no mipmap levels: only isNoTexture and isLazyTexture options are used.
+SiAnim * anim_load_sheet(const std::string & imagePath, const SiSheetGrid & grid, const SiLoadOption & option);
+// tablePath is a JSON frame table in the Aseprite / TexturePacker "frames" format (array or hash)
+SiAnim * anim_load_sheet(const std::string & imagePath, const std::string & tablePath, const SiLoadOption & option);
 SiAnim * anim_create_color(int width, int height, Uint32 color);
+// Generate mipmap levels for all anims loaded afterwards, whatever SiLoadOption::isMipmap
+void anim_set_mipmap(const bool isMipmap);
+// Free the decode buffers kept by the calling thread to speed up next loads
+void anim_release_scratch();
 
 #endif // MEDIA_READER_H
@@ -19,6 +19,9 @@
 
 #include "reader.h"
 #include "SdlItem.h"
+#include "SdlItemContext.h"
+#include "SiCamera.h"
+#include "SiItemStore.h"
 #include <functional>
 #include <SDL2/SDL.h>
 #include <SiAnim.h>
@@ -47,26 +50,57 @@
 #define MOUSE_WHEEL_UP		3
 #define MOUSE_WHEEL_DOWN	4
 
+// Following sdl_* calls from this thread use context, the default one if nullptr
+void sdl_set_context(SdlItemContext * context);
+SdlItemContext & sdl_get_context();
+
 void sdl_init(const std::string & title, const bool vsync);
 void sdl_cleanup(void);
 SDL_Renderer * sdl_get_renderer();
+Uint32 sdl_get_texture_format();
 
 void sdl_set_pixel(SDL_Surface *surface, int x, int y, Uint32 R, Uint32 G, Uint32 B, Uint32 A);
 Uint32 sdl_get_pixel(SDL_Surface *surface, int x, int y);
 
 // Return true if a mouse event has been detected
 bool sdl_mouse_manager(SDL_Event * event, std::vector<SdlItem*> & itemArray);
+// Same for all items of store, read straight from its dense arrays
+bool sdl_mouse_manager(SDL_Event * event, SiItemStore & store);
+// Same for the items drawn by camera, only hit if the mouse is in its viewport
+bool sdl_mouse_manager(SDL_Event * event, SiItemStore & store, const SiCamera & camera);
 
 void sdl_mouse_position_manager(std::vector<SdlItem *> & itemArray);
+void sdl_mouse_position_manager(SiItemStore & store);
+void sdl_mouse_position_manager(SiItemStore & store, const SiCamera & camera);
 int sdl_screen_manager(SDL_Event * event);
 void sdl_loop_manager();
+// Call stepCb rate times per second from sdl_loop_manager(), at most
+// maxStepQty times per frame. The cameras and the items of the stores added
+// by sdl_add_step_store() are drawn interpolated between the last two steps.
+// A rate of 0 goes back to the camera following wall-clock time.
+// Ignored if rate is negative, or maxStepQty is not positive while rate is.
+void sdl_set_fixed_step(const int rate, const int maxStepQty, const std::function<void()> & stepCb);
+void sdl_add_step_store(SiItemStore & store);
+void sdl_remove_step_store(SiItemStore & store);
+// Part of a step elapsed since the last one, from 0 to 1
+double sdl_get_step_alpha();
 void sdl_blit_tex(SDL_Texture * tex, SDL_Rect * rect, double angle, double zoomX, double zoomY, int flip, int overlay);
+void sdl_blit_tex(SDL_Texture * tex, const SDL_FRect * rect, double angle, double zoomX, double zoomY, int flip, int overlay);
 int sdl_blit_anim(const SiAnim & anim, SDL_Rect * rect, const double angle, const double zoomX, const double zoomY, const bool isFlip, const bool isLoop,
 		const bool isOverlay, const Uint32 animStartTick);
+int sdl_blit_anim(const SiAnim & anim, const SDL_FRect * rect, const double angle, const double zoomX, const double zoomY, const bool isFlip,
+		const bool isLoop, const bool isOverlay, const Uint32 animStartTick);
+// Whole pixel positions and sizes for pixel art, sub-pixel by default
+void sdl_set_pixel_snap(const bool isPixelSnap);
 void sdl_get_string_size(TTF_Font * font, const std::string & text, int * w, int *h);
 void sdl_print_item(SdlItem & item);
 int sdl_blit_item(SdlItem & item);
+int sdl_blit_item(SdlItem & item, const SiCamera & camera);
 void sdl_blit_item_list(std::vector<SdlItem> & itemArray);
+// Draw all items of store, read straight from its dense arrays
+void sdl_blit_store(SiItemStore & store);
+// Same seen by camera, clipped to its viewport
+void sdl_blit_store(SiItemStore & store, const SiCamera & camera);
 void sdl_keyboard_text_init(std::string * buf, const std::function<void(std::string)>& editCb);
 void sdl_init_screen();
 const std::string & sdl_keyboard_text_get_buf();
@@ -77,6 +111,11 @@ bool sdl_keyboard_manager(SDL_Event * event);
 void sdl_blit_to_screen();
 void sdl_set_virtual_x(int x);
 void sdl_set_virtual_y(int y);
+// Sub-pixel camera position
+void sdl_set_virtual_xf(const double x);
+void sdl_set_virtual_yf(const double y);
+double sdl_get_virtual_xf();
+double sdl_get_virtual_yf();
 void sdl_set_virtual_z(double z);
 int sdl_get_virtual_x();
 int sdl_get_virtual_y();
@@ -84,12 +123,18 @@ double sdl_get_virtual_z();
 void sdl_force_virtual_x(int x);
 void sdl_force_virtual_y(int y);
 void sdl_force_virtual_z(double z);
+// Camera of the sdl_* functions without camera parameter, set by sdl_*_virtual_*
+SiCamera & sdl_get_camera();
+// Other cameras, moved by sdl_loop_manager() as the default one
+void sdl_add_camera(SiCamera & camera);
+void sdl_remove_camera(SiCamera & camera);
 void sdl_add_down_key_cb(const SDL_Scancode code, const std::function<void()> & downCb);
 void sdl_add_up_key_cb(const SDL_Scancode code, const std::function<void()> & upCb);
 void sdl_clean_key_cb();
 void sdl_add_mousecb(Uint32 event_type, std::function<void()> callBack);
 void sdl_free_mousecb();
 Uint32 sdl_get_global_time();
+void sdl_set_texture_release_delay(const Uint32 delay);
 SiAnim * sdl_get_minimal_anim();
 void sdl_set_background_color(int R, int G, int B, int A);
 void sdl_get_output_size(int * width, int * height);
@@ -0,0 +1,52 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef SDL_ITEM_TRACKER_H
+#define SDL_ITEM_TRACKER_H
+
+#include <functional>
+#include <SDL.h>
+
+// What a texture was created for
+enum class TextureOrigin
+{
+	LOADER, COLOR, TEXT, MINIMAL_ANIM, STREAM, PACK
+};
+
+// All textures of the library are created and destroyed through these
+// functions, so that their memory usage is known.
+SDL_Texture * tracker_create_texture(const Uint32 format, const int access, const int width, const int height, const TextureOrigin origin);
+SDL_Texture * tracker_create_texture_from_surface(SDL_Surface * surface, const TextureOrigin origin);
+void tracker_destroy_texture(SDL_Texture * texture);
+
+// Totals of textures alive, in bytes of pixels
+Uint64 tracker_get_byte_qty();
+Uint64 tracker_get_byte_qty(const TextureOrigin origin);
+int tracker_get_texture_qty();
+int tracker_get_texture_qty(const TextureOrigin origin);
+
+// Log totals per origin and the qty textures using the most memory,
+// all of them if qty is negative
+void tracker_dump(const int qty);
+
+// budgetCb is called with the total byte qty when it goes above budget.
+// 0 disables the budget.
+void tracker_set_budget(const Uint64 budget, const std::function<void(Uint64)> & budgetCb);
+
+#endif // SDL_ITEM_TRACKER_H
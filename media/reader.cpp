@@ -17,43 +17,134 @@
  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
  */
 
+#include "reader.h"
 #include "sdl.h"
+#include "si_file.h"
 #include "si_gif.h"
 #include "si_libav.h"
 #include "si_png.h"
+#include "si_scratch.h"
+#include "si_sheet.h"
 #include "si_zip.h"
 #include "SiAnim.h"
+#include "tracker.h"
 #include <string>
 
+static bool isMipmapForced = false;
+
+/*****************************************************************************/
+static void set_total_duration(SiAnim * anim)
+{
+	Uint32 totalDuration = 0U;
+
+	for (auto && delay : anim->getDelayArray())
+	{
+		totalDuration += delay;
+	}
+
+	anim->setTotalDuration(totalDuration);
+}
+
 /*****************************************************************************/
 SiAnim * anim_load(const std::string & filePath)
+{
+	return anim_load(filePath, SiLoadOption());
+}
+
+/*****************************************************************************/
+SiAnim * anim_load(const std::string & filePath, const SiLoadOption & loadOption)
 {
 	SiAnim * ret;
+	FileMap file;
+	SiLoadOption option = loadOption;
+
+	if (isMipmapForced == true)
+	{
+		option.isMipmap = true;
+	}
 
-	ret = giflib_load(filePath);
+	// The file is mapped once, each decoder probes the same bytes
+	if (file.open(filePath) == false)
+	{
+		return nullptr;
+	}
+
+	const Uint8 * data = file.getData();
+	const size_t size = file.getSize();
+
+	ret = giflib_load(data, size, option);
 	if (ret == nullptr)
 	{
-		ret = libpng_load(filePath);
+		ret = libpng_load(data, size, option);
 		if (ret == nullptr)
 		{
-			ret = libzip_load(filePath);
+			ret = libzip_load(data, size, option);
 			if (ret == nullptr)
 			{
-				ret = libav_load(filePath);
+				ret = libav_load(data, size, option);
 			}
 		}
 	}
 
 	if (ret != nullptr)
 	{
-		Uint32 totalDuration = 0U;
-
-		for (auto && delay : ret->getDelayArray())
+		// Identical frames already share their texture
+		if (option.isMergeFrames == true)
 		{
-			totalDuration += delay;
+			ret->mergeRepeatedFrames();
 		}
+		set_total_duration(ret);
+	}
+
+	return ret;
+}
+
+/*****************************************************************************/
+SiAnim * anim_load_stream(const std::string & filePath)
+{
+	return anim_load_stream(filePath, SiLoadOption());
+}
+
+/*****************************************************************************/
+SiAnim * anim_load_stream(const std::string & filePath, const SiLoadOption & option)
+{
+	return libav_load_stream(filePath, option);
+}
+
+/*****************************************************************************/
+SiAnim * anim_load_sheet(const std::string & imagePath, const SiSheetGrid & grid, const SiLoadOption & option)
+{
+	FileMap image;
+
+	if (image.open(imagePath) == false)
+	{
+		return nullptr;
+	}
 
-		ret->setTotalDuration(totalDuration);
+	SiAnim * ret = sheet_load_grid(image.getData(), image.getSize(), grid, option);
+	if (ret != nullptr)
+	{
+		set_total_duration(ret);
+	}
+
+	return ret;
+}
+
+/*****************************************************************************/
+SiAnim * anim_load_sheet(const std::string & imagePath, const std::string & tablePath, const SiLoadOption & option)
+{
+	FileMap image;
+	FileMap table;
+
+	if ((image.open(imagePath) == false) || (table.open(tablePath) == false))
+	{
+		return nullptr;
+	}
+
+	SiAnim * ret = sheet_load_table(image.getData(), image.getSize(), (const char *) table.getData(), table.getSize(), option);
+	if (ret != nullptr)
+	{
+		set_total_duration(ret);
 	}
 
 	return ret;
@@ -78,9 +169,21 @@ SiAnim * anim_create_color(int width, int height, Uint32 color)
 		to_fill[i] = color;
 	}
 
-	anim->pushTexture(SDL_CreateTextureFromSurface(sdl_get_renderer(), surf));
+	anim->pushTexture(tracker_create_texture_from_surface(surf, TextureOrigin::COLOR));
 
 	SDL_FreeSurface(surf);
 
 	return anim;
 }
+
+/*****************************************************************************/
+void anim_set_mipmap(const bool isMipmap)
+{
+	isMipmapForced = isMipmap;
+}
+
+/*****************************************************************************/
+void anim_release_scratch()
+{
+	scratch_release();
+}
@@ -0,0 +1,155 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "si_file.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*****************************************************************************/
+FileMap::FileMap() :
+		m_data(nullptr), m_size(0U)
+{
+}
+
+/*****************************************************************************/
+FileMap::~FileMap()
+{
+	close();
+}
+
+/*****************************************************************************/
+bool FileMap::open(const std::string & filePath)
+{
+	close();
+
+	const int fd = ::open(filePath.c_str(), O_RDONLY);
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	struct stat fileStat;
+	if ((fstat(fd, &fileStat) == -1) || (fileStat.st_size <= 0))
+	{
+		::close(fd);
+		return false;
+	}
+
+	void * data = mmap(nullptr, (size_t) fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping stays valid once the file is closed
+	::close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+
+	// Decoders read files from start to end
+	madvise(data, (size_t) fileStat.st_size, MADV_SEQUENTIAL);
+
+	m_data = data;
+	m_size = (size_t) fileStat.st_size;
+
+	return true;
+}
+
+/*****************************************************************************/
+void FileMap::close()
+{
+	if (m_data != nullptr)
+	{
+		munmap(m_data, m_size);
+		m_data = nullptr;
+		m_size = 0U;
+	}
+}
+
+/*****************************************************************************/
+const Uint8 * FileMap::getData() const
+{
+	return (const Uint8 *) m_data;
+}
+
+/*****************************************************************************/
+size_t FileMap::getSize() const
+{
+	return m_size;
+}
+
+/*****************************************************************************/
+MemReader::MemReader() :
+		m_data(nullptr), m_size(0U), m_offset(0U)
+{
+}
+
+/*****************************************************************************/
+MemReader::MemReader(const Uint8 * data, const size_t size) :
+		m_data(data), m_size(size), m_offset(0U)
+{
+}
+
+/*****************************************************************************/
+size_t MemReader::read(void * dest, const size_t size)
+{
+	size_t readSize = m_size - m_offset;
+	if (size < readSize)
+	{
+		readSize = size;
+	}
+
+	memcpy(dest, m_data + m_offset, readSize);
+	m_offset += readSize;
+
+	return readSize;
+}
+
+/*****************************************************************************/
+bool MemReader::seek(const size_t offset)
+{
+	if (offset > m_size)
+	{
+		return false;
+	}
+
+	m_offset = offset;
+
+	return true;
+}
+
+/*****************************************************************************/
+size_t MemReader::tell() const
+{
+	return m_offset;
+}
+
+/*****************************************************************************/
+const Uint8 * MemReader::getData() const
+{
+	return m_data;
+}
+
+/*****************************************************************************/
+size_t MemReader::getSize() const
+{
+	return m_size;
+}
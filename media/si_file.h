@@ -0,0 +1,71 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef MEDIA_FILE_H
+#define MEDIA_FILE_H
+
+#include <SDL.h>
+#include <string>
+
+// Read only memory mapping of a whole file. It is mapped once and its bytes
+// are handed to every decoder probing it.
+class FileMap
+{
+public:
+	FileMap();
+	~FileMap();
+
+	FileMap(const FileMap &) = delete;
+	FileMap & operator=(const FileMap &) = delete;
+
+	// return false if error
+	bool open(const std::string & filePath);
+	const Uint8 * getData() const;
+	size_t getSize() const;
+
+private:
+	void close();
+
+	void * m_data;
+	size_t m_size;
+};
+
+// Sequential reader over bytes in memory, used as user data of the
+// decoders read callbacks. Nothing is copied until read() is called.
+class MemReader
+{
+public:
+	MemReader();
+	MemReader(const Uint8 * data, const size_t size);
+
+	// return the number of bytes copied to dest
+	size_t read(void * dest, const size_t size);
+	// return false if offset is out of data
+	bool seek(const size_t offset);
+	size_t tell() const;
+	const Uint8 * getData() const;
+	size_t getSize() const;
+
+private:
+	const Uint8 * m_data;
+	size_t m_size;
+	size_t m_offset;
+};
+
+#endif // MEDIA_FILE_H
@@ -0,0 +1,535 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "reader.h"
+#include "sdl.h"
+#include "si_frame.h"
+#include "si_scale.h"
+#include "si_scratch.h"
+#include "SiAnim.h"
+
+// A delta frame is only used if it is smaller than this fraction of a full frame
+static constexpr int DELTA_MAX_RATIO = 2;
+// Seed and primes of the pixels hash (from xxHash64)
+static constexpr Uint64 HASH_SEED = 0x27D4EB2F165667C5ULL;
+static constexpr Uint64 HASH_PRIME_1 = 0x9E3779B185EBCA87ULL;
+static constexpr Uint64 HASH_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+// Smallest level is 1/16 of the anim, and not smaller than MIPMAP_MIN_SIZE
+static constexpr int MIPMAP_MAX_LEVEL = 4;
+static constexpr int MIPMAP_MIN_SIZE = 8;
+
+/*****************************************************************************/
+FrameEncoder::FrameEncoder(SiAnim & anim, const SiLoadOption & option) :
+		m_anim(anim), m_option(option), m_keySurf(nullptr), m_keyFrame(SiAnim::NO_KEY_FRAME), m_dirty(
+		{ 0, 0, 0, 0 }), m_savedBytes(0U), m_frameHashMap()
+{
+}
+
+/*****************************************************************************/
+FrameEncoder::~FrameEncoder()
+{
+	if (m_keySurf != nullptr)
+	{
+		SDL_FreeSurface(m_keySurf);
+	}
+}
+
+/******************************************************************************
+ Return the bounding box of the pixels of area which differ between a and b
+ *****************************************************************************/
+static SDL_Rect get_diff_rect(SDL_Surface * a, SDL_Surface * b, const SDL_Rect & area)
+{
+	SDL_Rect diff =
+	{ 0, 0, 0, 0 };
+	int left = area.x + area.w;
+	int right = area.x - 1;
+	int top = area.y + area.h;
+	int bottom = area.y - 1;
+
+	for (int y = area.y; y < area.y + area.h; y++)
+	{
+		const Uint32 * lineA = (const Uint32 *) ((const Uint8 *) a->pixels + y * a->pitch);
+		const Uint32 * lineB = (const Uint32 *) ((const Uint8 *) b->pixels + y * b->pitch);
+
+		int x = area.x;
+		while ((x < area.x + area.w) && (lineA[x] == lineB[x]))
+		{
+			x++;
+		}
+
+		if (x == area.x + area.w)
+		{
+			continue;
+		}
+
+		if (x < left)
+		{
+			left = x;
+		}
+
+		x = area.x + area.w - 1;
+		while (lineA[x] == lineB[x])
+		{
+			x--;
+		}
+
+		if (x > right)
+		{
+			right = x;
+		}
+
+		if (y < top)
+		{
+			top = y;
+		}
+		bottom = y;
+	}
+
+	if (right >= left)
+	{
+		diff.x = left;
+		diff.y = top;
+		diff.w = right - left + 1;
+		diff.h = bottom - top + 1;
+	}
+
+	return diff;
+}
+
+/*****************************************************************************/
+SDL_Rect frame_get_opaque_rect(SDL_Surface * surf, const SDL_Rect & area)
+{
+	SDL_Rect opaque =
+	{ 0, 0, 0, 0 };
+	const Uint32 alphaMask = surf->format->Amask;
+	int left = area.x + area.w;
+	int right = area.x - 1;
+	int top = area.y + area.h;
+	int bottom = area.y - 1;
+
+	// Without alpha channel all pixels are opaque
+	if (alphaMask == 0U)
+	{
+		return area;
+	}
+
+	for (int y = area.y; y < area.y + area.h; y++)
+	{
+		const Uint32 * line = (const Uint32 *) ((const Uint8 *) surf->pixels + y * surf->pitch);
+
+		int x = area.x;
+		while ((x < area.x + area.w) && ((line[x] & alphaMask) == 0U))
+		{
+			x++;
+		}
+
+		if (x == area.x + area.w)
+		{
+			continue;
+		}
+
+		if (x < left)
+		{
+			left = x;
+		}
+
+		x = area.x + area.w - 1;
+		while ((line[x] & alphaMask) == 0U)
+		{
+			x--;
+		}
+
+		if (x > right)
+		{
+			right = x;
+		}
+
+		if (y < top)
+		{
+			top = y;
+		}
+		bottom = y;
+	}
+
+	if (right >= left)
+	{
+		opaque.x = left;
+		opaque.y = top;
+		opaque.w = right - left + 1;
+		opaque.h = bottom - top + 1;
+	}
+
+	return opaque;
+}
+
+/******************************************************************************
+ Return true if drawing the area of canvas over the key frame gives canvas:
+ each pixel of the area is opaque, or transparent in both surfaces
+ *****************************************************************************/
+static bool is_delta_drawable(SDL_Surface * canvas, SDL_Surface * key, const SDL_Rect & area)
+{
+	const Uint32 alphaMask = canvas->format->Amask;
+
+	if (alphaMask == 0U)
+	{
+		return true;
+	}
+
+	for (int y = area.y; y < area.y + area.h; y++)
+	{
+		const Uint32 * line = (const Uint32 *) ((const Uint8 *) canvas->pixels + y * canvas->pitch);
+		const Uint32 * keyLine = (const Uint32 *) ((const Uint8 *) key->pixels + y * key->pitch);
+
+		for (int x = area.x; x < area.x + area.w; x++)
+		{
+			const Uint32 alpha = line[x] & alphaMask;
+
+			if (alpha == alphaMask)
+			{
+				continue;
+			}
+
+			if ((alpha != 0U) || ((keyLine[x] & alphaMask) != 0U))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ 64 bits hash of the pixels of a 32 bits per pixel surface, mixing each pixel
+ pair like an xxHash64 round. Frames with the same hash may still differ.
+ *****************************************************************************/
+static Uint64 hash_pixels(SDL_Surface * surf)
+{
+	Uint64 hash = HASH_SEED ^ ((Uint64) surf->w << 32) ^ (Uint64) surf->h;
+
+	for (int y = 0; y < surf->h; y++)
+	{
+		const Uint8 * line = (const Uint8 *) surf->pixels + y * surf->pitch;
+		int x = 0;
+
+		for (; x + 1 < surf->w; x += 2)
+		{
+			Uint64 word;
+			memcpy(&word, line + x * 4, sizeof(word));
+			hash ^= word * HASH_PRIME_2;
+			hash = ((hash << 31) | (hash >> 33)) * HASH_PRIME_1;
+		}
+
+		if (x < surf->w)
+		{
+			Uint32 pixel;
+			memcpy(&pixel, line + x * 4, sizeof(pixel));
+			hash ^= pixel * HASH_PRIME_2;
+			hash = ((hash << 31) | (hash >> 33)) * HASH_PRIME_1;
+		}
+	}
+
+	// Final avalanche of xxHash64
+	hash ^= hash >> 33;
+	hash *= HASH_PRIME_2;
+	hash ^= hash >> 29;
+
+	return hash;
+}
+
+/******************************************************************************
+ Create a texture from the rect part of a 32 bits per pixel surface
+ *****************************************************************************/
+SDL_Texture * frame_create_texture(SDL_Surface * surf, const SDL_Rect & rect)
+{
+	const Uint8 * pixels = (const Uint8 *) surf->pixels + rect.y * surf->pitch + rect.x * 4;
+
+	return frame_create_texture(surf->format->format, pixels, surf->pitch, rect.w, rect.h, TextureOrigin::LOADER);
+}
+
+/*****************************************************************************/
+SDL_Texture * frame_create_texture(const Uint32 format, const void * pixels, const int pitch, const int width, const int height, const TextureOrigin origin)
+{
+	SDL_Texture * tex = tracker_create_texture(format, SDL_TEXTUREACCESS_STATIC, width, height, origin);
+	if (tex == nullptr)
+	{
+		return nullptr;
+	}
+
+	SDL_UpdateTexture(tex, nullptr, pixels, pitch);
+	SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+
+	return tex;
+}
+
+/*****************************************************************************/
+static void push_one(SiAnim & anim, SDL_Surface * canvas, const SDL_Rect & rect, const int keyFrame, const SiLoadOption & option)
+{
+	// An empty delta frame just displays its key frame
+	if (SDL_RectEmpty(&rect) == SDL_TRUE)
+	{
+		anim.pushTexture(nullptr, rect, keyFrame);
+		return;
+	}
+
+	if ((option.isNoTexture == false) && (option.isLazyTexture == false))
+	{
+		anim.pushTexture(frame_create_texture(canvas, rect), rect, keyFrame);
+		return;
+	}
+
+	SDL_Surface * surf = SDL_CreateRGBSurfaceWithFormat(0, rect.w, rect.h, 32, canvas->format->format);
+	if (surf != nullptr)
+	{
+		for (int y = 0; y < rect.h; y++)
+		{
+			memcpy((Uint8 *) surf->pixels + y * surf->pitch, (const Uint8 *) canvas->pixels + (rect.y + y) * canvas->pitch + rect.x * 4, rect.w * 4);
+		}
+	}
+
+	anim.pushSurface(surf, rect, keyFrame);
+}
+
+/*****************************************************************************/
+void frame_push(SiAnim & anim, SDL_Surface * canvas, const SDL_Rect & frameRect, const int keyFrame, const SiLoadOption & option)
+{
+	SDL_Rect rect = frameRect;
+
+	// Transparent pixels of a delta frame hide its key frame, they are kept
+	if ((option.isTrim == true) && (keyFrame == SiAnim::NO_KEY_FRAME))
+	{
+		rect = frame_get_opaque_rect(canvas, rect);
+	}
+
+	push_one(anim, canvas, rect, keyFrame, option);
+
+	if (option.isMipmap == false)
+	{
+		return;
+	}
+
+	// The number of levels is set by the first frame, all frames have the same levels
+	if (anim.getFrameQty() == 1)
+	{
+		int width = canvas->w;
+		int height = canvas->h;
+		while ((anim.getLevelQty() < MIPMAP_MAX_LEVEL) && (width >= MIPMAP_MIN_SIZE * 2) && (height >= MIPMAP_MIN_SIZE * 2))
+		{
+			width = (width + 1) / 2;
+			height = (height + 1) / 2;
+
+			SiAnim * level = new SiAnim;
+			level->setWidth(width);
+			level->setHeight(height);
+			anim.pushLevel(level);
+		}
+	}
+
+	SDL_Surface * source = canvas;
+	SDL_Rect levelRect = rect;
+
+	for (int i = 0; i < anim.getLevelQty(); i++)
+	{
+		levelRect = scale_half_rect(levelRect);
+
+		// Each level is computed from the previous one, which must not be overwritten
+		SDL_Surface * half = nullptr;
+		if (SDL_RectEmpty(&levelRect) == SDL_FALSE)
+		{
+			const ScratchSlot slot = (i % 2 == 0) ? ScratchSlot::MIPMAP_EVEN : ScratchSlot::MIPMAP_ODD;
+			half = scratch_create_surface(slot, (source->w + 1) / 2, (source->h + 1) / 2, source->format->format);
+		}
+
+		if (half == nullptr)
+		{
+			// Levels keep the same frame count as the anim
+			levelRect.w = 0;
+			levelRect.h = 0;
+			for (int j = i; j < anim.getLevelQty(); j++)
+			{
+				anim.getLevel(j).pushTexture(nullptr, levelRect, keyFrame);
+			}
+			break;
+		}
+
+		scale_half_to(source, half);
+		push_one(anim.getLevel(i), half, levelRect, keyFrame, option);
+
+		if (source != canvas)
+		{
+			SDL_FreeSurface(source);
+		}
+		source = half;
+	}
+
+	if (source != canvas)
+	{
+		SDL_FreeSurface(source);
+	}
+}
+
+/*****************************************************************************/
+void FrameEncoder::pushKeyFrame(SDL_Surface * canvas, const Uint64 hash)
+{
+	if ((m_keySurf == nullptr) || (m_keySurf->w != canvas->w) || (m_keySurf->h != canvas->h) || (m_keySurf->format->format != canvas->format->format))
+	{
+		if (m_keySurf != nullptr)
+		{
+			SDL_FreeSurface(m_keySurf);
+		}
+		m_keySurf = scratch_create_surface(ScratchSlot::KEY_FRAME, canvas->w, canvas->h, canvas->format->format);
+		if (m_keySurf == nullptr)
+		{
+			// Next frame is tried again as a key frame
+			m_keyFrame = SiAnim::NO_KEY_FRAME;
+			m_frameHashMap.clear();
+			m_anim.pushEmptyFrame();
+			return;
+		}
+	}
+
+	for (int y = 0; y < canvas->h; y++)
+	{
+		memcpy((Uint8 *) m_keySurf->pixels + y * m_keySurf->pitch, (const Uint8 *) canvas->pixels + y * canvas->pitch, canvas->w * 4);
+	}
+
+	SDL_Rect rect =
+	{ 0, 0, canvas->w, canvas->h };
+	frame_push(m_anim, canvas, rect, SiAnim::NO_KEY_FRAME, m_option);
+
+	m_keyFrame = m_anim.getFrameQty() - 1;
+	m_dirty.w = 0;
+	m_dirty.h = 0;
+
+	// Frames of the previous key frame can't be compared anymore
+	FrameCopy copy;
+	copy.frameIndex = m_keyFrame;
+	copy.rect =
+	{ 0, 0, 0, 0 };
+	m_frameHashMap.clear();
+	m_frameHashMap.emplace(hash, std::move(copy));
+}
+
+/******************************************************************************
+ canvas has the size and format of the key frame
+ *****************************************************************************/
+bool FrameEncoder::isSameFrame(SDL_Surface * canvas, const FrameCopy & copy) const
+{
+	const int rowSize = canvas->w * 4;
+	const int rectRowSize = copy.rect.w * 4;
+
+	for (int y = 0; y < canvas->h; y++)
+	{
+		const Uint8 * line = (const Uint8 *) canvas->pixels + y * canvas->pitch;
+		const Uint8 * keyLine = (const Uint8 *) m_keySurf->pixels + y * m_keySurf->pitch;
+
+		if ((y < copy.rect.y) || (y >= copy.rect.y + copy.rect.h))
+		{
+			if (memcmp(line, keyLine, rowSize) != 0)
+			{
+				return false;
+			}
+			continue;
+		}
+
+		const int left = copy.rect.x * 4;
+		const int right = left + rectRowSize;
+		const Uint8 * copyLine = copy.pixels.data() + (y - copy.rect.y) * rectRowSize;
+
+		if ((memcmp(line, keyLine, left) != 0) || (memcmp(line + left, copyLine, rectRowSize) != 0)
+				|| (memcmp(line + right, keyLine + right, rowSize - right) != 0))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*****************************************************************************/
+void FrameEncoder::push(SDL_Surface * canvas, const SDL_Rect * hint)
+{
+	const Uint64 hash = hash_pixels(canvas);
+
+	if ((m_keySurf == nullptr) || (m_keySurf->w != canvas->w) || (m_keySurf->h != canvas->h) || (m_keySurf->format->format != canvas->format->format))
+	{
+		pushKeyFrame(canvas, hash);
+		return;
+	}
+
+	SDL_Rect full =
+	{ 0, 0, canvas->w, canvas->h };
+
+	if (hint == nullptr)
+	{
+		m_dirty = full;
+	}
+	else
+	{
+		SDL_Rect clippedHint;
+		if (SDL_IntersectRect(hint, &full, &clippedHint) == SDL_TRUE)
+		{
+			SDL_UnionRect(&m_dirty, &clippedHint, &m_dirty);
+		}
+	}
+
+	// m_dirty is kept up to date, the next frame may differ from the key frame
+	auto it = m_frameHashMap.find(hash);
+	if ((it != m_frameHashMap.end()) && (isSameFrame(canvas, it->second) == true))
+	{
+		const SDL_Rect & rect = m_anim.getFrameRect(it->second.frameIndex);
+		m_savedBytes += (Uint64) rect.w * rect.h * 4U;
+		m_anim.pushFrameCopy(it->second.frameIndex);
+		return;
+	}
+
+	SDL_Rect delta =
+	{ 0, 0, 0, 0 };
+	if (SDL_RectEmpty(&m_dirty) == SDL_FALSE)
+	{
+		delta = get_diff_rect(canvas, m_keySurf, m_dirty);
+	}
+
+	// Delta frames are drawn over their key frame, which they can't erase
+	if ((delta.w * delta.h * DELTA_MAX_RATIO >= full.w * full.h) || (is_delta_drawable(canvas, m_keySurf, delta) == false))
+	{
+		pushKeyFrame(canvas, hash);
+		return;
+	}
+
+	frame_push(m_anim, canvas, delta, m_keyFrame, m_option);
+	m_savedBytes += (Uint64) (full.w * full.h - delta.w * delta.h) * 4U;
+
+	// On a hash collision, the first frame stays the one compared
+	FrameCopy copy;
+	copy.frameIndex = m_anim.getFrameQty() - 1;
+	copy.rect = delta;
+	copy.pixels.resize(delta.w * delta.h * 4);
+	for (int y = 0; y < delta.h; y++)
+	{
+		memcpy(copy.pixels.data() + y * delta.w * 4, (const Uint8 *) canvas->pixels + (delta.y + y) * canvas->pitch + delta.x * 4, delta.w * 4);
+	}
+	m_frameHashMap.emplace(hash, std::move(copy));
+}
+
+/*****************************************************************************/
+Uint64 FrameEncoder::getSavedBytes() const
+{
+	return m_savedBytes;
+}
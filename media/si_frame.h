@@ -0,0 +1,77 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef MEDIA_FRAME_H
+#define MEDIA_FRAME_H
+
+#include <SDL.h>
+#include "tracker.h"
+#include <unordered_map>
+#include <vector>
+
+class SiAnim;
+struct SiLoadOption;
+
+// Push decoded frames of the same size to an anim. Frames which differ
+// from the last key frame on a small area are stored as delta frames.
+// Frames identical to a previous one since the last key frame share its
+// texture. Only the pixels of these frames are kept to compare them.
+class FrameEncoder
+{
+public:
+	FrameEncoder(SiAnim & anim, const SiLoadOption & option);
+	~FrameEncoder();
+
+	// canvas is a 32 bits per pixel surface.
+	// hint, if not nullptr, contains all pixels changed since previous frame
+	void push(SDL_Surface * canvas, const SDL_Rect * hint);
+
+	// Texture memory not allocated thanks to delta and shared frames, in bytes
+	Uint64 getSavedBytes() const;
+
+private:
+	// Pixels of a frame pushed since the last key frame
+	struct FrameCopy
+	{
+		int frameIndex;
+		SDL_Rect rect; // area differing from the key frame, empty for the key frame
+		std::vector<Uint8> pixels; // of rect
+	};
+
+	void pushKeyFrame(SDL_Surface * canvas, const Uint64 hash);
+	// Hashes may collide, the pixels are compared
+	bool isSameFrame(SDL_Surface * canvas, const FrameCopy & copy) const;
+
+	SiAnim & m_anim;
+	const SiLoadOption & m_option;
+	SDL_Surface * m_keySurf; // copy of the last key frame
+	int m_keyFrame;
+	SDL_Rect m_dirty; // area which may differ from the last key frame
+	Uint64 m_savedBytes;
+	std::unordered_map<Uint64, FrameCopy> m_frameHashMap; // pixels hash of each different frame since the key frame
+};
+
+SDL_Texture * frame_create_texture(SDL_Surface * surf, const SDL_Rect & rect);
+SDL_Texture * frame_create_texture(const Uint32 format, const void * pixels, const int pitch, const int width, const int height, const TextureOrigin origin);
+// Bounding box of the pixels of area whose alpha is not 0
+SDL_Rect frame_get_opaque_rect(SDL_Surface * surf, const SDL_Rect & area);
+// Push the rect area of canvas as a new frame of anim
+void frame_push(SiAnim & anim, SDL_Surface * canvas, const SDL_Rect & rect, const int keyFrame, const SiLoadOption & option);
+
+#endif // MEDIA_FRAME_H
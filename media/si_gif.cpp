@@ -17,10 +17,16 @@
  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
  */
 
+#include "reader.h"
 #include "sdl.h"
+#include "si_file.h"
+#include "si_frame.h"
+#include "si_scale.h"
+#include "si_scratch.h"
 #include "SiAnim.h"
 #include <SDL2/SDL.h>
 #include <string>
+#include <vector>
 
 #ifdef __cplusplus
 extern "C"
@@ -37,41 +43,107 @@ static constexpr int GIF_GCE = 0xf9;
 
 static constexpr int DEFAULT_DELAY_MS = 40;
 
+// Interlaced images are sent in 4 passes, see GIF89a specification Appendix E
+static constexpr int INTERLACED_OFFSET[] =
+{ 0, 4, 2, 1 };
+static constexpr int INTERLACED_JUMP[] =
+{ 8, 8, 4, 2 };
+
+/************************************************************************
+ Write one raster line of the current image into the render surface
+ ************************************************************************/
+static void draw_line(SDL_Surface * surf, const GifByteType * line, int frame_left, int frame_width, int y, const ColorMapObject * pal, int transparent,
+		unsigned char transparent_color)
+{
+	if ((y < 0) || (y >= surf->h))
+	{
+		return;
+	}
+
+	for (int x = 0; x < frame_width; x++)
+	{
+		if ((x + frame_left) >= surf->w)
+		{
+			break;
+		}
+
+		int col = line[x];
+		if (col == transparent_color && transparent)
+		{
+			// Transparent color means do not touch the render
+			continue;
+		}
+
+		if (col >= pal->ColorCount)
+		{
+			continue;
+		}
+
+		int pix_index = (x + frame_left) * 4;
+		char * pixels = (char*) surf->pixels + y * surf->pitch;
+		pixels[pix_index + 3] = pal->Colors[col].Red;
+		pixels[pix_index + 2] = pal->Colors[col].Green;
+		pixels[pix_index + 1] = pal->Colors[col].Blue;
+		pixels[pix_index + 0] = 0xFF;
+	}
+}
+
+/*****************************************************************************/
+static int read_data(GifFileType * gif, GifByteType * dest, int size)
+{
+	MemReader * reader = (MemReader *) gif->UserData;
+
+	return (int) reader->read(dest, (size_t) size);
+}
+
 /************************************************************************
  return nullptr if error
+ Frames are decoded record by record: each frame is composited and
+ pushed to the anim as soon as its raster is read, so only the render
+ surface, the DISPOSE_PREVIOUS backup, the last key frame and one raster
+ line are kept in memory whatever the size of the file. option.frameCb
+ is called with each frame, the first one can be displayed before the
+ rest of the file is decoded.
  http://www.imagemagick.org/Usage/anim_basics/#dispose
  http://wwwcdf.pd.infn.it/libgif/gif89.txt
  http://wwwcdf.pd.infn.it/libgif/gif_lib.html
  ************************************************************************/
-SiAnim * giflib_load(const std::string & filePath)
+SiAnim * giflib_load(const Uint8 * data, const size_t size, const SiLoadOption & option)
 {
 	GifFileType * gif = nullptr;
-	int i = 0;
-	int j = 0;
+	GifRecordType recordType = UNDEFINED_RECORD_TYPE;
+	GifByteType * extension = nullptr;
+	int extensionCode = 0;
 	int transparent = 0;
 	unsigned char transparent_color = 0;
 	int disposal = 0;
 	int delay = 0;
-	ColorMapObject * global_pal = nullptr;
 	ColorMapObject * pal = nullptr;
 	SDL_Surface* surf = nullptr;
 	SDL_Surface* prev_surf = nullptr;
 	int x = 0;
 	int y = 0;
-	int col = 0;
+	int pass = 0;
 	int pix_index = 0;
 	SiAnim * anim = nullptr;
 	int render_width;
 	int render_height;
+	int width = 0;
+	int height = 0;
 	int frame_left = 0;
 	int frame_top = 0;
 	int frame_width = 0;
 	int frame_height = 0;
 	int allow_draw = 1;
+	SDL_Rect hint =
+	{ 0, 0, 0, 0 };
+	SDL_Rect disposed =
+	{ 0, 0, 0, 0 };
 	int error = 0;
-	int ret;
+	bool isError = false;
+	MemReader reader(data, size);
 
-	gif = DGifOpenFileName(filePath.c_str(), &error);
+	gif = DGifOpen(&reader, read_data, &error);
 	if (gif == nullptr)
 	{
 #if 0
@@ -80,135 +152,257 @@ SiAnim * giflib_load(const std::string & filePath)
 		return nullptr;
 	}
 
-	ret = DGifSlurp(gif);
-	if (ret != GIF_OK)
-	{
-		DGifCloseFile(gif, &error);
-		return nullptr;
-	}
-	if (gif->Error != D_GIF_SUCCEEDED)
-	{
-		DGifCloseFile(gif, &error);
-		return nullptr;
-	}
-
-	anim = new SiAnim;
-
-	anim->setWidth(gif->SWidth);
-	anim->setHeight(gif->SHeight);
-
 	render_width = gif->SWidth;
 	render_height = gif->SHeight;
 	//bg_color = gif->SBackGroundColor;
 
-	surf = SDL_CreateRGBSurface(0, render_width, render_height, 32, 0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff);
-	prev_surf = SDL_CreateRGBSurface(0, render_width, render_height, 32, 0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff);
+	// Frames are composited at full size and shrunk afterwards
+	scale_get_size(option, render_width, render_height, &width, &height);
+
+	anim = new SiAnim;
 
-	global_pal = gif->SColorMap;
-	pal = global_pal;
+	anim->setWidth(width);
+	anim->setHeight(height);
+
+	// Canvases are reused from previous loads
+	surf = scratch_create_surface(ScratchSlot::CANVAS, render_width, render_height, SDL_PIXELFORMAT_RGBA8888);
+	prev_surf = scratch_create_surface(ScratchSlot::PREVIOUS_CANVAS, render_width, render_height, SDL_PIXELFORMAT_RGBA8888);
+	if ((surf == nullptr) || (prev_surf == nullptr))
+	{
+		SDL_FreeSurface(surf);
+		SDL_FreeSurface(prev_surf);
+		DGifCloseFile(gif, &error);
+		delete anim;
+		return nullptr;
+	}
 
 	// Init with transparent background
-	memset(surf->pixels, 0, render_height * render_width * 4);
+	memset(surf->pixels, 0, render_height * surf->pitch);
+	memset(prev_surf->pixels, 0, render_height * prev_surf->pitch);
+
+	FrameEncoder encoder(*anim, option);
+
+	// Current raster line
+	GifByteType * line = scratch_get(ScratchSlot::GIF_LINE, render_width);
+	int line_size = render_width;
 
-	for (i = 0; i < gif->ImageCount; i++)
+	do
 	{
-		frame_left = gif->SavedImages[i].ImageDesc.Left;
-		frame_top = gif->SavedImages[i].ImageDesc.Top;
-		frame_width = gif->SavedImages[i].ImageDesc.Width;
-		frame_height = gif->SavedImages[i].ImageDesc.Height;
-
-		// select palette
-		pal = global_pal;
-		if (gif->SavedImages[i].ImageDesc.ColorMap)
+		if (DGifGetRecordType(gif, &recordType) == GIF_ERROR)
 		{
-			pal = gif->SavedImages[i].ImageDesc.ColorMap;
+			isError = true;
+			break;
 		}
-		// GCE
-		for (j = 0; j < gif->SavedImages[i].ExtensionBlockCount; j++)
+
+		switch (recordType)
 		{
-			if (gif->SavedImages[i].ExtensionBlocks[j].Function == GIF_GCE)
+		case EXTENSION_RECORD_TYPE:
+			if (DGifGetExtension(gif, &extensionCode, &extension) == GIF_ERROR)
+			{
+				isError = true;
+				break;
+			}
+
+			// GCE: extension[0] is the block size
+			if ((extensionCode == GIF_GCE) && (extension != nullptr) && (extension[0] >= 4))
 			{
-				transparent = gif->SavedImages[i].ExtensionBlocks[j].Bytes[0] & 0x01;
-				disposal = (gif->SavedImages[i].ExtensionBlocks[j].Bytes[0] & 28) >> 2;
-				delay = (gif->SavedImages[i].ExtensionBlocks[j].Bytes[1] + gif->SavedImages[i].ExtensionBlocks[j].Bytes[2] * 256) * 10;
+				transparent = extension[1] & 0x01;
+				disposal = (extension[1] & 28) >> 2;
+				delay = (extension[2] + extension[3] * 256) * 10;
 				if (delay == 0)
 				{
 					delay = DEFAULT_DELAY_MS;
 				}
 				if (transparent)
 				{
-					transparent_color = gif->SavedImages[i].ExtensionBlocks[j].Bytes[3];
+					transparent_color = extension[4];
 				}
 			}
-		}
 
-		// Save the current render if needed
-		if (disposal == DISPOSE_PREVIOUS)
-		{
-			memcpy(prev_surf->pixels, surf->pixels, render_height * render_width * 4);
-		}
+			while (extension != nullptr)
+			{
+				if (DGifGetExtensionNext(gif, &extension) == GIF_ERROR)
+				{
+					isError = true;
+					break;
+				}
+			}
+			break;
+
+		case IMAGE_DESC_RECORD_TYPE:
+			if (DGifGetImageDesc(gif) == GIF_ERROR)
+			{
+				isError = true;
+				break;
+			}
+
+			frame_left = gif->Image.Left;
+			frame_top = gif->Image.Top;
+			frame_width = gif->Image.Width;
+			frame_height = gif->Image.Height;
+
+			// Malformed files may declare an image wider than the logical screen
+			if (frame_width > line_size)
+			{
+				line = scratch_get(ScratchSlot::GIF_LINE, frame_width);
+				line_size = frame_width;
+			}
+
+			// select palette
+			pal = gif->SColorMap;
+			if (gif->Image.ColorMap)
+			{
+				pal = gif->Image.ColorMap;
+			}
+
+			if (pal == nullptr)
+			{
+				isError = true;
+				break;
+			}
 
-		// Fill surface buffer with raster bytes
-		if (allow_draw)
-		{ // See DISPOSE_DO_NOT
-			for (y = 0; y < frame_height; y++)
+			// Save the current render if needed
+			if (disposal == DISPOSE_PREVIOUS)
+			{
+				memcpy(prev_surf->pixels, surf->pixels, render_height * surf->pitch);
+			}
+
+			// Fill surface buffer with raster bytes
+			// Lines must be read even if they are not drawn (see DISPOSE_DO_NOT)
+			if (gif->Image.Interlace)
+			{
+				for (pass = 0; (pass < 4) && (isError == false); pass++)
+				{
+					for (y = INTERLACED_OFFSET[pass]; y < frame_height; y += INTERLACED_JUMP[pass])
+					{
+						if (DGifGetLine(gif, line, frame_width) == GIF_ERROR)
+						{
+							isError = true;
+							break;
+						}
+						if (allow_draw)
+						{
+							draw_line(surf, line, frame_left, frame_width, y + frame_top, pal, transparent, transparent_color);
+						}
+					}
+				}
+			}
+			else
 			{
-				for (x = 0; x < frame_width; x++)
+				for (y = 0; y < frame_height; y++)
 				{
-					pix_index = ((x + frame_left) + ((y + frame_top) * render_width)) * 4;
-					col = gif->SavedImages[i].RasterBits[(x) + (y) * frame_width];
-					if (col == transparent_color && transparent)
+					if (DGifGetLine(gif, line, frame_width) == GIF_ERROR)
 					{
-						// Transparent color means do not touch the render
+						isError = true;
+						break;
 					}
-					else
+					if (allow_draw)
 					{
-						((char*) surf->pixels)[pix_index + 3] = pal->Colors[col].Red;
-						((char*) surf->pixels)[pix_index + 2] = pal->Colors[col].Green;
-						((char*) surf->pixels)[pix_index + 1] = pal->Colors[col].Blue;
-						((char*) surf->pixels)[pix_index + 0] = 0xFF;
+						draw_line(surf, line, frame_left, frame_width, y + frame_top, pal, transparent, transparent_color);
 					}
 				}
 			}
-		}
 
-		anim->pushDelay(delay);
-		anim->pushTexture(SDL_CreateTextureFromSurface(sdl_get_renderer(), surf));
+			if (isError == true)
+			{
+				break;
+			}
 
-		// Prepare next rendering depending of disposal
-		allow_draw = 1;
-		switch (disposal)
-		{
-		// Do not touch render for next frame
-		case DISPOSE_DO_NOT:
-			allow_draw = 0;
-			break;
-		case DISPOSE_BACKGROUND:
-			// Draw transparent color in frame
-			for (y = 0; y < frame_height; y++)
+			// Only this image and the area disposed after previous one may have changed
+			hint.x = frame_left;
+			hint.y = frame_top;
+			hint.w = frame_width;
+			hint.h = frame_height;
+			SDL_UnionRect(&hint, &disposed, &hint);
+
+			anim->pushDelay(delay);
+			if ((width != render_width) || (height != render_height))
 			{
-				for (x = 0; x < frame_width; x++)
+				SDL_Surface * scaled = scratch_create_surface(ScratchSlot::SCALED, width, height, surf->format->format);
+				if (scaled == nullptr)
 				{
-					pix_index = ((x + frame_left) + ((y + frame_top) * render_width)) * 4;
-					((char*) surf->pixels)[pix_index + 3] = 0;
-					((char*) surf->pixels)[pix_index + 2] = 0;
-					((char*) surf->pixels)[pix_index + 1] = 0;
-					((char*) surf->pixels)[pix_index + 0] = 0;
+					// Same as the ZIP loader, the frame keeps its delay
+					anim->pushEmptyFrame();
+				}
+				else
+				{
+					scale_surface_to(surf, scaled);
+					SDL_Rect scaledHint = scale_rect(hint, render_width, render_height, width, height);
+					encoder.push(scaled, &scaledHint);
+					SDL_FreeSurface(scaled);
 				}
 			}
+			else
+			{
+				encoder.push(surf, &hint);
+			}
+
+			if (bool(option.frameCb) == true)
+			{
+				option.frameCb(*anim, anim->getFrameQty() - 1);
+			}
+
+			disposed.w = 0;
+			disposed.h = 0;
+
+			// Prepare next rendering depending of disposal
+			allow_draw = 1;
+			switch (disposal)
+			{
+			// Do not touch render for next frame
+			case DISPOSE_DO_NOT:
+				allow_draw = 0;
+				break;
+			case DISPOSE_BACKGROUND:
+				disposed.x = frame_left;
+				disposed.y = frame_top;
+				disposed.w = frame_width;
+				disposed.h = frame_height;
+				// Draw transparent color in frame
+				for (y = frame_top; (y < frame_top + frame_height) && (y < render_height); y++)
+				{
+					for (x = frame_left; (x < frame_left + frame_width) && (x < render_width); x++)
+					{
+						pix_index = x * 4;
+						char * pixels = (char*) surf->pixels + y * surf->pitch;
+						pixels[pix_index + 3] = 0;
+						pixels[pix_index + 2] = 0;
+						pixels[pix_index + 1] = 0;
+						pixels[pix_index + 0] = 0;
+					}
+				}
+				break;
+			case DISPOSE_PREVIOUS:
+				disposed.x = frame_left;
+				disposed.y = frame_top;
+				disposed.w = frame_width;
+				disposed.h = frame_height;
+				// Restore previous render in frame
+				memcpy(surf->pixels, prev_surf->pixels, render_height * surf->pitch);
+				break;
+			default:
+				break;
+			}
 			break;
-		case DISPOSE_PREVIOUS:
-			// Restore previous render in frame
-			memcpy(surf->pixels, prev_surf->pixels, render_height * render_width * 4);
-			break;
+
+		case TERMINATE_RECORD_TYPE:
 		default:
 			break;
 		}
-	}
+	} while ((recordType != TERMINATE_RECORD_TYPE) && (isError == false));
+
 	SDL_FreeSurface(surf);
 	SDL_FreeSurface(prev_surf);
 
 	DGifCloseFile(gif, &error);
 
+	if (isError == true)
+	{
+		delete anim;
+		return nullptr;
+	}
+
+	SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "GIF: %llu bytes of texture saved by delta frames", (unsigned long long) encoder.getSavedBytes());
+
 	return anim;
 }
@@ -20,10 +20,11 @@
 #ifndef MEDIA_GIF_H
 #define MEDIA_GIF_H
 
-#include <string>
+#include <SDL.h>
 
 class SiAnim;
+struct SiLoadOption;
 
-SiAnim * giflib_load(const std::string & filePath);
+SiAnim * giflib_load(const Uint8 * data, const size_t size, const SiLoadOption & option);
 
 #endif // MEDIA_GIF_H
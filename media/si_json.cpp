@@ -0,0 +1,374 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "si_json.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Nesting deeper than this is rejected instead of overflowing the stack
+static constexpr int MAX_DEPTH = 64;
+
+struct JsonCursor
+{
+	const char * current;
+	const char * end;
+};
+
+static bool parse_value(JsonCursor & cursor, JsonValue & value, const int depth);
+
+/*****************************************************************************/
+static void skip_space(JsonCursor & cursor)
+{
+	while ((cursor.current < cursor.end)
+			&& ((*cursor.current == ' ') || (*cursor.current == '\t') || (*cursor.current == '\n') || (*cursor.current == '\r')))
+	{
+		cursor.current++;
+	}
+}
+
+/*****************************************************************************/
+static bool parse_word(JsonCursor & cursor, const char * word)
+{
+	const size_t length = strlen(word);
+
+	if ((size_t) (cursor.end - cursor.current) < length)
+	{
+		return false;
+	}
+	if (memcmp(cursor.current, word, length) != 0)
+	{
+		return false;
+	}
+
+	cursor.current += length;
+
+	return true;
+}
+
+/******************************************************************************
+ \uXXXX escapes are stored as UTF-8, surrogate pairs are not combined
+ *****************************************************************************/
+static void append_utf8(std::string & string, const unsigned int code)
+{
+	if (code < 0x80U)
+	{
+		string += (char) code;
+	}
+	else if (code < 0x800U)
+	{
+		string += (char) (0xC0U | (code >> 6));
+		string += (char) (0x80U | (code & 0x3FU));
+	}
+	else
+	{
+		string += (char) (0xE0U | (code >> 12));
+		string += (char) (0x80U | ((code >> 6) & 0x3FU));
+		string += (char) (0x80U | (code & 0x3FU));
+	}
+}
+
+/*****************************************************************************/
+static bool parse_string(JsonCursor & cursor, std::string & string)
+{
+	if ((cursor.current >= cursor.end) || (*cursor.current != '"'))
+	{
+		return false;
+	}
+	cursor.current++;
+
+	while (cursor.current < cursor.end)
+	{
+		const char c = *cursor.current++;
+
+		if (c == '"')
+		{
+			return true;
+		}
+
+		if (c != '\\')
+		{
+			string += c;
+			continue;
+		}
+
+		if (cursor.current >= cursor.end)
+		{
+			return false;
+		}
+
+		const char escape = *cursor.current++;
+		switch (escape)
+		{
+		case '"':
+		case '\\':
+		case '/':
+			string += escape;
+			break;
+		case 'b':
+			string += '\b';
+			break;
+		case 'f':
+			string += '\f';
+			break;
+		case 'n':
+			string += '\n';
+			break;
+		case 'r':
+			string += '\r';
+			break;
+		case 't':
+			string += '\t';
+			break;
+		case 'u':
+		{
+			if (cursor.end - cursor.current < 4)
+			{
+				return false;
+			}
+			char hex[5] =
+			{ 0 };
+			memcpy(hex, cursor.current, 4);
+			char * hexEnd = nullptr;
+			const unsigned long code = strtoul(hex, &hexEnd, 16);
+			if (hexEnd != hex + 4)
+			{
+				return false;
+			}
+			append_utf8(string, (unsigned int) code);
+			cursor.current += 4;
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+
+	return false;
+}
+
+/*****************************************************************************/
+static bool parse_number(JsonCursor & cursor, double & number)
+{
+	// strtod needs a terminated string
+	std::string text;
+
+	while ((cursor.current < cursor.end) && (strchr("+-0123456789.eE", *cursor.current) != nullptr))
+	{
+		text += *cursor.current++;
+	}
+
+	if (text.empty() == true)
+	{
+		return false;
+	}
+
+	char * numberEnd = nullptr;
+	number = strtod(text.c_str(), &numberEnd);
+
+	return numberEnd == text.c_str() + text.size();
+}
+
+/*****************************************************************************/
+static bool parse_array(JsonCursor & cursor, JsonValue & value, const int depth)
+{
+	// Opening bracket already read
+	skip_space(cursor);
+	if ((cursor.current < cursor.end) && (*cursor.current == ']'))
+	{
+		cursor.current++;
+		return true;
+	}
+
+	while (cursor.current < cursor.end)
+	{
+		value.array.emplace_back();
+		if (parse_value(cursor, value.array.back(), depth + 1) == false)
+		{
+			return false;
+		}
+
+		skip_space(cursor);
+		if (cursor.current >= cursor.end)
+		{
+			return false;
+		}
+
+		const char c = *cursor.current++;
+		if (c == ']')
+		{
+			return true;
+		}
+		if (c != ',')
+		{
+			return false;
+		}
+	}
+
+	return false;
+}
+
+/*****************************************************************************/
+static bool parse_object(JsonCursor & cursor, JsonValue & value, const int depth)
+{
+	// Opening brace already read
+	skip_space(cursor);
+	if ((cursor.current < cursor.end) && (*cursor.current == '}'))
+	{
+		cursor.current++;
+		return true;
+	}
+
+	while (cursor.current < cursor.end)
+	{
+		value.object.emplace_back();
+		std::pair<std::string, JsonValue> & member = value.object.back();
+
+		skip_space(cursor);
+		if (parse_string(cursor, member.first) == false)
+		{
+			return false;
+		}
+
+		skip_space(cursor);
+		if ((cursor.current >= cursor.end) || (*cursor.current != ':'))
+		{
+			return false;
+		}
+		cursor.current++;
+
+		if (parse_value(cursor, member.second, depth + 1) == false)
+		{
+			return false;
+		}
+
+		skip_space(cursor);
+		if (cursor.current >= cursor.end)
+		{
+			return false;
+		}
+
+		const char c = *cursor.current++;
+		if (c == '}')
+		{
+			return true;
+		}
+		if (c != ',')
+		{
+			return false;
+		}
+	}
+
+	return false;
+}
+
+/*****************************************************************************/
+static bool parse_value(JsonCursor & cursor, JsonValue & value, const int depth)
+{
+	if (depth > MAX_DEPTH)
+	{
+		return false;
+	}
+
+	skip_space(cursor);
+	if (cursor.current >= cursor.end)
+	{
+		return false;
+	}
+
+	switch (*cursor.current)
+	{
+	case '{':
+		cursor.current++;
+		value.type = JsonValue::Type::OBJECT;
+		return parse_object(cursor, value, depth);
+	case '[':
+		cursor.current++;
+		value.type = JsonValue::Type::ARRAY;
+		return parse_array(cursor, value, depth);
+	case '"':
+		value.type = JsonValue::Type::STRING;
+		return parse_string(cursor, value.string);
+	case 't':
+		value.type = JsonValue::Type::BOOLEAN;
+		value.boolean = true;
+		return parse_word(cursor, "true");
+	case 'f':
+		value.type = JsonValue::Type::BOOLEAN;
+		value.boolean = false;
+		return parse_word(cursor, "false");
+	case 'n':
+		value.type = JsonValue::Type::NUL;
+		return parse_word(cursor, "null");
+	default:
+		value.type = JsonValue::Type::NUMBER;
+		return parse_number(cursor, value.number);
+	}
+}
+
+/*****************************************************************************/
+const JsonValue * JsonValue::get(const std::string & key) const
+{
+	if (type != Type::OBJECT)
+	{
+		return nullptr;
+	}
+
+	for (auto && member : object)
+	{
+		if (member.first == key)
+		{
+			return &member.second;
+		}
+	}
+
+	return nullptr;
+}
+
+/*****************************************************************************/
+double JsonValue::getNumber(const std::string & key, const double defaultValue) const
+{
+	const JsonValue * member = get(key);
+
+	if ((member == nullptr) || (member->type != Type::NUMBER))
+	{
+		return defaultValue;
+	}
+
+	return member->number;
+}
+
+/*****************************************************************************/
+bool json_parse(const char * data, const size_t size, JsonValue & value)
+{
+	JsonCursor cursor =
+	{ data, data + size };
+
+	value = JsonValue();
+
+	if (parse_value(cursor, value, 0) == false)
+	{
+		return false;
+	}
+
+	// Only white space may follow the document
+	skip_space(cursor);
+
+	return cursor.current == cursor.end;
+}
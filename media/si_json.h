@@ -0,0 +1,51 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef MEDIA_JSON_H
+#define MEDIA_JSON_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal JSON document, only used to read frame tables of sprite sheets
+struct JsonValue
+{
+	enum class Type
+	{
+		NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT
+	};
+
+	Type type = Type::NUL;
+	bool boolean = false;
+	double number = 0.0;
+	std::string string;
+	std::vector<JsonValue> array;
+	std::vector<std::pair<std::string, JsonValue>> object; // members in file order
+
+	// return nullptr if this is not an object or has no member named key
+	const JsonValue * get(const std::string & key) const;
+	// return defaultValue if member key is not a number
+	double getNumber(const std::string & key, const double defaultValue) const;
+};
+
+// return false if data is not a valid JSON document
+bool json_parse(const char * data, const size_t size, JsonValue & value);
+
+#endif // MEDIA_JSON_H
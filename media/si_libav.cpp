@@ -17,9 +17,21 @@
  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
  */
 
+#include "reader.h"
 #include "sdl.h"
+#include "si_file.h"
+#include "si_scale.h"
+#include "si_scratch.h"
 #include "SiAnim.h"
+#include "SiStream.h"
+#include "tracker.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
 #include <string>
+#include <thread>
+#include <vector>
 
 #ifdef __cplusplus
 extern "C"
@@ -35,135 +47,319 @@ extern "C"
 }
 #endif
 
+// Decoded frames waiting to be displayed by a stream
+static constexpr int STREAM_FRAME_QTY = 4;
+
+// Size of the buffer libav reads the file through
+static constexpr int IO_BUFFER_SIZE = 32768;
+
 /*****************************************************************************/
-SiAnim * libav_load(const std::string & filePath)
+static int read_data(void * opaque, uint8_t * dest, int size)
+{
+	MemReader * reader = (MemReader *) opaque;
+
+	const size_t readSize = reader->read(dest, (size_t) size);
+	if (readSize == 0U)
+	{
+		return AVERROR_EOF;
+	}
+
+	return (int) readSize;
+}
+
+/*****************************************************************************/
+static int64_t seek_data(void * opaque, int64_t offset, int whence)
+{
+	MemReader * reader = (MemReader *) opaque;
+	int64_t position = 0;
+
+	switch (whence & ~AVSEEK_FORCE)
+	{
+	case AVSEEK_SIZE:
+		return (int64_t) reader->getSize();
+	case SEEK_SET:
+		position = offset;
+		break;
+	case SEEK_CUR:
+		position = (int64_t) reader->tell() + offset;
+		break;
+	case SEEK_END:
+		position = (int64_t) reader->getSize() + offset;
+		break;
+	default:
+		return -1;
+	}
+
+	if ((position < 0) || (reader->seek((size_t) position) == false))
+	{
+		return -1;
+	}
+
+	return position;
+}
+
+/*****************************************************************************/
+static void close_io(AVIOContext ** ioCtx)
+{
+	if (*ioCtx != nullptr)
+	{
+		av_freep(&(*ioCtx)->buffer);
+		av_freep(ioCtx);
+	}
+}
+
+/******************************************************************************
+ Open the video read by reader and its first video stream decoder.
+ ioCtx must be freed with close_io() after formatCtx is closed.
+ return false if error
+ *****************************************************************************/
+static bool open_video(MemReader * reader, AVIOContext ** ioCtx, AVFormatContext ** formatCtx, AVCodecContext ** codexCtx, int * videoStream, int * delay)
 {
-	SiAnim * ret = nullptr;
-	unsigned int i = 0;
-	SiAnim * anim = new SiAnim;
-	struct SwsContext * swsCtx;
-	int videoStream = -1;
-	int delay = 0;
 	AVCodec *codec = nullptr;
-	AVFrame *decodedFrame = nullptr;
-	AVFrame *frameRgba = nullptr;
-	AVCodecContext *codexCtx = nullptr;
 
 	// Register all formats and codecs
 	av_register_all();
 
-	// Open video file
-	AVFormatContext *formatCtx = nullptr;
-	if (avformat_open_input(&formatCtx, filePath.c_str(), nullptr, nullptr) != 0)
+	// Read the file from memory instead of letting libav open it again
+	unsigned char * buffer = (unsigned char *) av_malloc(IO_BUFFER_SIZE);
+	if (buffer == nullptr)
 	{
-		goto error;
+		return false;
 	}
 
-	if (avformat_find_stream_info(formatCtx, nullptr) < 0)
+	*ioCtx = avio_alloc_context(buffer, IO_BUFFER_SIZE, 0, reader, read_data, nullptr, seek_data);
+	if (*ioCtx == nullptr)
 	{
-		goto error;
+		av_free(buffer);
+		return false;
+	}
+
+	*formatCtx = avformat_alloc_context();
+	if (*formatCtx == nullptr)
+	{
+		return false;
+	}
+	(*formatCtx)->pb = *ioCtx;
+
+	// Open video, formatCtx is freed on failure
+	if (avformat_open_input(formatCtx, nullptr, nullptr, nullptr) != 0)
+	{
+		return false;
+	}
+
+	if (avformat_find_stream_info(*formatCtx, nullptr) < 0)
+	{
+		return false;
 	}
 
 	// Find the first video stream
-	for (unsigned int i = 0; i < formatCtx->nb_streams; i++)
+	for (unsigned int i = 0; i < (*formatCtx)->nb_streams; i++)
 	{
-		if (formatCtx->streams[i]->codec->codec_type == AVMEDIA_TYPE_VIDEO)
+		if ((*formatCtx)->streams[i]->codec->codec_type == AVMEDIA_TYPE_VIDEO)
 		{
-			videoStream = i;
+			*videoStream = i;
 			// total stream duration (in nanosecond) / number of image in the stream / 1000 (to get milliseconds
-			delay = formatCtx->duration / formatCtx->streams[i]->duration / 1000;
+			*delay = (*formatCtx)->duration / (*formatCtx)->streams[i]->duration / 1000;
 			// If the above doesn't work try with frame_rate :
 			//delay = pFormatCtx->streams[i]->r_frame_rate;
 			break;
 		}
 	}
 
-	if (videoStream == -1)
+	if (*videoStream == -1)
 	{
-		goto error;
+		return false;
 	}
 
 	// Get a pointer to the codec context for the video stream
-	codexCtx = formatCtx->streams[videoStream]->codec;
+	*codexCtx = (*formatCtx)->streams[*videoStream]->codec;
 
 	// Find the decoder for the video stream
-	codec = avcodec_find_decoder(codexCtx->codec_id);
+	codec = avcodec_find_decoder((*codexCtx)->codec_id);
 	if (codec == nullptr)
 	{
-		goto error;
+		*codexCtx = nullptr;
+		return false;
 	}
 
+	// Let the decoder use all cores
+	(*codexCtx)->thread_count = 0;
+	(*codexCtx)->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
 	// Open codec
-	if (avcodec_open2(codexCtx, codec, nullptr) < 0)
+	if (avcodec_open2(*codexCtx, codec, nullptr) < 0)
+	{
+		*codexCtx = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ return true if frames can be uploaded as they are decoded, leaving the
+ YUV to RGB conversion to the renderer
+ *****************************************************************************/
+static bool is_native_yuv(const AVPixelFormat pixelFormat)
+{
+	// Full range YUV (AV_PIX_FMT_YUVJ420P) would not be rendered with the right levels
+	if (pixelFormat != AV_PIX_FMT_YUV420P)
+	{
+		return false;
+	}
+
+	SDL_RendererInfo info;
+	if (SDL_GetRendererInfo(sdl_get_renderer(), &info) < 0)
+	{
+		return false;
+	}
+
+	for (Uint32 i = 0U; i < info.num_texture_formats; i++)
+	{
+		if (info.texture_formats[i] == SDL_PIXELFORMAT_IYUV)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*****************************************************************************/
+SiAnim * libav_load(const Uint8 * data, const size_t size, const SiLoadOption & option)
+{
+	SiAnim * ret = nullptr;
+	unsigned int i = 0;
+	SiAnim * anim = new SiAnim;
+	struct SwsContext * swsCtx = nullptr;
+	int videoStream = -1;
+	int delay = 0;
+	int width = 0;
+	int height = 0;
+	AVFrame *decodedFrame = nullptr;
+	AVFrame *frameConverted = nullptr;
+	AVFrame *frameUploaded = nullptr;
+	AVCodecContext *codexCtx = nullptr;
+	AVFormatContext *formatCtx = nullptr;
+	AVIOContext *ioCtx = nullptr;
+	MemReader reader(data, size);
+	bool isYuv = false;
+	bool isEnd = false;
+
+	// Video frames are uploaded as they are decoded, they are not kept in CPU memory
+	if (option.isNoTexture == true)
+	{
+		goto error;
+	}
+
+	if (open_video(&reader, &ioCtx, &formatCtx, &codexCtx, &videoStream, &delay) == false)
 	{
 		goto error;
 	}
 
+	isYuv = is_native_yuv(codexCtx->pix_fmt);
+	scale_get_size(option, codexCtx->width, codexCtx->height, &width, &height);
+
 	// Allocate video frame
 #if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(55,28,1)
 	decodedFrame = av_frame_alloc();
-	frameRgba = av_frame_alloc();
+	frameConverted = av_frame_alloc();
 #else
 	decodedFrame = avcodec_alloc_frame();
-	frameRgba = avcodec_alloc_frame();
+	frameConverted = avcodec_alloc_frame();
 #endif
 
 	if (decodedFrame == nullptr)
 	{
 		goto error;
 	}
-	if (frameRgba == nullptr)
+	if (frameConverted == nullptr)
 	{
 		goto error;
 	}
 
-	frameRgba->format = AV_PIX_FMT_RGBA;
-	frameRgba->height = codexCtx->height;
-	frameRgba->width = codexCtx->width;
-	av_frame_get_buffer(frameRgba, 16);
+	// swscale converts to RGBA and/or shrinks frames, YUV planes are uploaded as they are otherwise
+	if ((isYuv == false) || (width != codexCtx->width) || (height != codexCtx->height))
+	{
+		frameConverted->format = isYuv ? AV_PIX_FMT_YUV420P : AV_PIX_FMT_RGBA;
+		frameConverted->height = height;
+		frameConverted->width = width;
 
-	swsCtx = sws_getContext(codexCtx->width, codexCtx->height, codexCtx->pix_fmt, codexCtx->width, codexCtx->height, AV_PIX_FMT_RGBA,
-	SWS_BILINEAR, nullptr, nullptr, nullptr);
+		// Converted pixels are only needed until they are uploaded
+		const AVPixelFormat format = (AVPixelFormat) frameConverted->format;
+		Uint8 * pixels = scratch_get(ScratchSlot::VIDEO_FRAME, av_image_get_buffer_size(format, width, height, 16));
+		av_image_fill_arrays(frameConverted->data, frameConverted->linesize, pixels, format, width, height, 16);
 
-	if (swsCtx == nullptr)
-	{
-		goto error;
+		swsCtx = sws_getContext(codexCtx->width, codexCtx->height, codexCtx->pix_fmt, width, height, (AVPixelFormat) frameConverted->format,
+		SWS_BILINEAR, nullptr, nullptr, nullptr);
+
+		if (swsCtx == nullptr)
+		{
+			goto error;
+		}
 	}
 
-	anim->setWidth(codexCtx->width);
-	anim->setHeight(codexCtx->height);
+	anim->setWidth(width);
+	anim->setHeight(height);
 
 // Read frames
 	AVPacket packet;
-	while (av_read_frame(formatCtx, &packet) >= 0)
+	while (isEnd == false)
 	{
-		// Is this a packet from the video stream?
-		if (packet.stream_index == videoStream)
+		if (av_read_frame(formatCtx, &packet) >= 0)
 		{
-			// Decode video frame
-			if (avcodec_send_packet(codexCtx, &packet) == 0)
+			// Is this a packet from the video stream?
+			if (packet.stream_index == videoStream)
+			{
+				// Decode video frame
+				avcodec_send_packet(codexCtx, &packet);
+			}
+
+			av_packet_unref(&packet);
+		}
+		else
+		{
+			// Get frames delayed by the decoder threads
+			avcodec_send_packet(codexCtx, nullptr);
+			isEnd = true;
+		}
+
+		while (avcodec_receive_frame(codexCtx, decodedFrame) == 0)
+		{
+			anim->pushDelay(delay);
+
+			frameUploaded = decodedFrame;
+			if (swsCtx != nullptr)
 			{
-				if (avcodec_receive_frame(codexCtx, decodedFrame) == 0)
+				// Convert the image from its native format to RGBA and/or to the requested size
+				sws_scale(swsCtx, (const uint8_t * const *) decodedFrame->data, decodedFrame->linesize, 0, codexCtx->height, frameConverted->data,
+						frameConverted->linesize);
+				frameUploaded = frameConverted;
+			}
+
+			if (isYuv == true)
+			{
+				anim->pushTexture(tracker_create_texture(SDL_PIXELFORMAT_IYUV, SDL_TEXTUREACCESS_STATIC, width, height, TextureOrigin::LOADER));
+
+				// Copy decoded planes to render texture
+				if (SDL_UpdateYUVTexture(anim->getFrame(i).texture->getTexture(), nullptr, frameUploaded->data[0], frameUploaded->linesize[0],
+						frameUploaded->data[1], frameUploaded->linesize[1], frameUploaded->data[2], frameUploaded->linesize[2]) < 0)
 				{
-					// Convert the image from its native format to RGBA
-					sws_scale(swsCtx, (const uint8_t * const *) decodedFrame->data, decodedFrame->linesize, 0, codexCtx->height, frameRgba->data,
-							frameRgba->linesize);
-
-					anim->pushDelay(delay);
-					anim->pushTexture(
-							SDL_CreateTexture(sdl_get_renderer(), SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STATIC, codexCtx->width, codexCtx->height));
-
-					// Copy decoded bits to render texture
-					if (SDL_UpdateTexture(anim->getTexture(i)->getTexture(), nullptr, frameRgba->data[0], frameRgba->linesize[0]) < 0)
-					{
-						//SDL_UpdateTexture error
-					}
-					i++;
+					//SDL_UpdateYUVTexture error
 				}
 			}
-		}
+			else
+			{
+				anim->pushTexture(tracker_create_texture(SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STATIC, width, height, TextureOrigin::LOADER));
 
-		av_packet_unref(&packet);
+				// Copy decoded bits to render texture
+				if (SDL_UpdateTexture(anim->getFrame(i).texture->getTexture(), nullptr, frameUploaded->data[0], frameUploaded->linesize[0]) < 0)
+				{
+					//SDL_UpdateTexture error
+				}
+			}
+			i++;
+		}
 	}
 
 	ret = anim;
@@ -175,9 +371,14 @@ SiAnim * libav_load(const std::string & filePath)
 		delete anim;
 	}
 
-	if (frameRgba)
+	if (swsCtx)
 	{
-		av_free(frameRgba);
+		sws_freeContext(swsCtx);
+	}
+
+	if (frameConverted)
+	{
+		av_free(frameConverted);
 	}
 
 	if (decodedFrame)
@@ -195,5 +396,549 @@ SiAnim * libav_load(const std::string & filePath)
 		avformat_close_input(&formatCtx);
 	}
 
+	close_io(&ioCtx);
+
 	return ret;
 }
+
+/******************************************************************************
+ Video decoded by a background thread into a small ring of frames.
+ The frame to display is uploaded into a single streaming texture, so
+ memory usage doesn't depend on the video length.
+ Frames are kept as YUV planes if the renderer can display them,
+ converted to RGBA otherwise.
+ *****************************************************************************/
+class LibavStream: public SiStream
+{
+public:
+	LibavStream();
+	virtual ~LibavStream();
+
+	bool open(const std::string & filePath, const SiLoadOption & option);
+
+	int getWidth() const;
+	int getHeight() const;
+
+	SDL_Texture * getTexture(const Uint32 startTick, const bool isLoop) override;
+	void pause() override;
+	void resume() override;
+	bool isPaused() const override;
+	void rewind() override;
+
+private:
+	struct Frame
+	{
+		std::vector<Uint8> pixels; // RGBA or Y, U and V planes
+		Uint32 time; // display time in milliseconds since the first frame
+	};
+
+	void decodeLoop();
+	bool decodeFrame(Frame & frame, Uint32 & frameTime);
+	void seekStart();
+	void upload(const Frame & frame);
+	Uint32 getPlayTime() const;
+	void requestRewind();
+
+	FileMap m_file;
+	MemReader m_reader;
+	AVIOContext * m_ioCtx;
+	AVFormatContext * m_formatCtx;
+	AVCodecContext * m_codexCtx;
+	AVFrame * m_decodedFrame;
+	struct SwsContext * m_swsCtx;
+	int m_videoStream;
+	int m_delay;
+	bool m_isDraining; // no more packets to send to the decoder
+	Uint32 m_lastPtsTime; // time of the last decoded frame in the file
+	Uint32 m_lastTime; // time of the last decoded frame, loops included
+	SDL_Texture * m_texture;
+	int m_width;
+	int m_height;
+	bool m_isYuv;
+	int m_planeQty;
+	int m_planeOffset[3]; // in Frame::pixels
+	int m_planePitch[3];
+	int m_planeHeight[3];
+
+	std::thread m_thread;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	Frame m_frameArray[STREAM_FRAME_QTY];
+	int m_frameHead;
+	int m_frameQty;
+	bool m_isQuit;
+	bool m_isEof;
+	bool m_isLoop;
+	bool m_isRewind;
+
+	// Play time is global time - start tick - m_timeOffset
+	bool m_isStarted;
+	Uint32 m_startTick;
+	Uint32 m_timeOffset;
+	bool m_isPaused;
+	Uint32 m_pausedTime;
+};
+
+/*****************************************************************************/
+LibavStream::LibavStream() :
+		m_file(), m_reader(), m_ioCtx(nullptr), m_formatCtx(nullptr), m_codexCtx(nullptr), m_decodedFrame(nullptr), m_swsCtx(nullptr), m_videoStream(-1), m_delay(0), m_isDraining(false), m_lastPtsTime(0U), m_lastTime(0U), m_texture(
+				nullptr), m_width(0), m_height(0), m_isYuv(false), m_planeQty(0), m_planeOffset(), m_planePitch(), m_planeHeight(), m_thread(), m_mutex(), m_condition(), m_frameArray(), m_frameHead(0), m_frameQty(0), m_isQuit(false), m_isEof(false), m_isLoop(
+				true), m_isRewind(false), m_isStarted(false), m_startTick(0U), m_timeOffset(0U), m_isPaused(false), m_pausedTime(0U)
+{
+}
+
+/*****************************************************************************/
+LibavStream::~LibavStream()
+{
+	if (m_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isQuit = true;
+		}
+		m_condition.notify_all();
+		m_thread.join();
+	}
+
+	if (m_texture != nullptr)
+	{
+		tracker_destroy_texture(m_texture);
+	}
+
+	if (m_swsCtx)
+	{
+		sws_freeContext(m_swsCtx);
+	}
+
+	if (m_decodedFrame)
+	{
+		av_free(m_decodedFrame);
+	}
+
+	if (m_codexCtx)
+	{
+		avcodec_close(m_codexCtx);
+	}
+
+	if (m_formatCtx)
+	{
+		avformat_close_input(&m_formatCtx);
+	}
+
+	close_io(&m_ioCtx);
+}
+
+/******************************************************************************
+ return false if error
+ *****************************************************************************/
+bool LibavStream::open(const std::string & filePath, const SiLoadOption & option)
+{
+	if (m_file.open(filePath) == false)
+	{
+		return false;
+	}
+	m_reader = MemReader(m_file.getData(), m_file.getSize());
+
+	if (open_video(&m_reader, &m_ioCtx, &m_formatCtx, &m_codexCtx, &m_videoStream, &m_delay) == false)
+	{
+		return false;
+	}
+
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(55,28,1)
+	m_decodedFrame = av_frame_alloc();
+#else
+	m_decodedFrame = avcodec_alloc_frame();
+#endif
+	if (m_decodedFrame == nullptr)
+	{
+		return false;
+	}
+
+	scale_get_size(option, m_codexCtx->width, m_codexCtx->height, &m_width, &m_height);
+	const int width = m_width;
+	const int height = m_height;
+
+	m_isYuv = is_native_yuv(m_codexCtx->pix_fmt);
+
+	// swscale converts to RGBA and/or shrinks frames, YUV planes are copied as they are otherwise
+	if ((m_isYuv == false) || (width != m_codexCtx->width) || (height != m_codexCtx->height))
+	{
+		m_swsCtx = sws_getContext(m_codexCtx->width, m_codexCtx->height, m_codexCtx->pix_fmt, width, height,
+				m_isYuv ? AV_PIX_FMT_YUV420P : AV_PIX_FMT_RGBA, SWS_BILINEAR, nullptr, nullptr, nullptr);
+		if (m_swsCtx == nullptr)
+		{
+			return false;
+		}
+	}
+
+	if (m_isYuv == true)
+	{
+		m_texture = tracker_create_texture(SDL_PIXELFORMAT_IYUV, SDL_TEXTUREACCESS_STREAMING, width, height, TextureOrigin::STREAM);
+
+		m_planeQty = 3;
+		m_planePitch[0] = width;
+		m_planeHeight[0] = height;
+		m_planePitch[1] = m_planePitch[2] = (width + 1) / 2;
+		m_planeHeight[1] = m_planeHeight[2] = (height + 1) / 2;
+	}
+	else
+	{
+		m_texture = tracker_create_texture(SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING, width, height, TextureOrigin::STREAM);
+
+		m_planeQty = 1;
+		m_planePitch[0] = width * 4;
+		m_planeHeight[0] = height;
+	}
+
+	if (m_texture == nullptr)
+	{
+		return false;
+	}
+
+	int frameSize = 0;
+	for (int i = 0; i < m_planeQty; i++)
+	{
+		m_planeOffset[i] = frameSize;
+		frameSize += m_planePitch[i] * m_planeHeight[i];
+	}
+
+	for (auto && frame : m_frameArray)
+	{
+		frame.pixels.resize(frameSize);
+		frame.time = 0U;
+	}
+
+	// Display the empty first slot until the first frame is decoded
+	if (m_isYuv == true)
+	{
+		// Black in YUV
+		memset(m_frameArray[0].pixels.data(), 16, m_planePitch[0] * m_planeHeight[0]);
+		memset(m_frameArray[0].pixels.data() + m_planeOffset[1], 128, frameSize - m_planeOffset[1]);
+	}
+	upload(m_frameArray[0]);
+
+	m_thread = std::thread(&LibavStream::decodeLoop, this);
+
+	return true;
+}
+
+/*****************************************************************************/
+int LibavStream::getWidth() const
+{
+	return m_width;
+}
+
+/*****************************************************************************/
+int LibavStream::getHeight() const
+{
+	return m_height;
+}
+
+/*****************************************************************************/
+void LibavStream::seekStart()
+{
+	av_seek_frame(m_formatCtx, m_videoStream, 0, AVSEEK_FLAG_BACKWARD);
+	avcodec_flush_buffers(m_codexCtx);
+	m_isDraining = false;
+	m_lastPtsTime = 0U;
+}
+
+/******************************************************************************
+ Decode next video frame into frame
+ frameTime is its presentation time in milliseconds
+ return false at end of stream
+ *****************************************************************************/
+bool LibavStream::decodeFrame(Frame & frame, Uint32 & frameTime)
+{
+	AVPacket packet;
+
+	while (avcodec_receive_frame(m_codexCtx, m_decodedFrame) != 0)
+	{
+		if (m_isDraining == true)
+		{
+			return false;
+		}
+
+		if (av_read_frame(m_formatCtx, &packet) < 0)
+		{
+			// Get frames delayed by the decoder threads
+			avcodec_send_packet(m_codexCtx, nullptr);
+			m_isDraining = true;
+			continue;
+		}
+
+		if (packet.stream_index == m_videoStream)
+		{
+			avcodec_send_packet(m_codexCtx, &packet);
+		}
+
+		av_packet_unref(&packet);
+	}
+
+	const AVStream * stream = m_formatCtx->streams[m_videoStream];
+	int64_t pts = m_decodedFrame->best_effort_timestamp;
+	if (pts == AV_NOPTS_VALUE)
+	{
+		frameTime = m_lastPtsTime + m_delay;
+	}
+	else
+	{
+		if (stream->start_time != AV_NOPTS_VALUE)
+		{
+			pts -= stream->start_time;
+		}
+		frameTime = pts * 1000 * stream->time_base.num / stream->time_base.den;
+	}
+	m_lastPtsTime = frameTime;
+
+	if (m_swsCtx != nullptr)
+	{
+		uint8_t * data[4] =
+		{ nullptr, nullptr, nullptr, nullptr };
+		int linesize[4] =
+		{ 0, 0, 0, 0 };
+
+		for (int i = 0; i < m_planeQty; i++)
+		{
+			data[i] = frame.pixels.data() + m_planeOffset[i];
+			linesize[i] = m_planePitch[i];
+		}
+
+		// Convert the image from its native format to RGBA and/or to the requested size
+		sws_scale(m_swsCtx, (const uint8_t * const *) m_decodedFrame->data, m_decodedFrame->linesize, 0, m_codexCtx->height, data, linesize);
+	}
+	else
+	{
+		for (int i = 0; i < m_planeQty; i++)
+		{
+			Uint8 * dest = frame.pixels.data() + m_planeOffset[i];
+			for (int y = 0; y < m_planeHeight[i]; y++)
+			{
+				memcpy(dest + y * m_planePitch[i], m_decodedFrame->data[i] + y * m_decodedFrame->linesize[i], m_planePitch[i]);
+			}
+		}
+	}
+
+	return true;
+}
+
+/*****************************************************************************/
+void LibavStream::upload(const Frame & frame)
+{
+	if (m_isYuv == true)
+	{
+		SDL_UpdateYUVTexture(m_texture, nullptr, frame.pixels.data() + m_planeOffset[0], m_planePitch[0], frame.pixels.data() + m_planeOffset[1],
+				m_planePitch[1], frame.pixels.data() + m_planeOffset[2], m_planePitch[2]);
+	}
+	else
+	{
+		SDL_UpdateTexture(m_texture, nullptr, frame.pixels.data(), m_planePitch[0]);
+	}
+}
+
+/******************************************************************************
+ Background thread: fill the frame ring until the stream is destroyed
+ *****************************************************************************/
+void LibavStream::decodeLoop()
+{
+	Uint32 loopOffset = 0U;
+
+	while (true)
+	{
+		int slot = 0;
+		bool isEof = false;
+		bool isSeek = false;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			m_condition.wait(lock, [this]()
+			{
+				return m_isQuit || m_isRewind || ((m_frameQty < STREAM_FRAME_QTY) && ((m_isEof == false) || (m_isLoop == true)));
+			});
+
+			if (m_isQuit == true)
+			{
+				return;
+			}
+
+			if (m_isRewind == true)
+			{
+				m_isRewind = false;
+				m_isEof = false;
+				loopOffset = 0U;
+				m_lastTime = 0U;
+				isSeek = true;
+			}
+			else if (m_isEof == true)
+			{
+				// Loop: following frames are displayed after the last one
+				m_isEof = false;
+				loopOffset = m_lastTime + m_delay;
+				isSeek = true;
+			}
+
+			// Slots outside of the ring are never read by the render thread
+			slot = (m_frameHead + m_frameQty) % STREAM_FRAME_QTY;
+		}
+
+		if (isSeek == true)
+		{
+			seekStart();
+		}
+
+		Uint32 frameTime = 0U;
+		isEof = (decodeFrame(m_frameArray[slot], frameTime) == false);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (isEof == true)
+		{
+			m_isEof = true;
+			continue;
+		}
+
+		// Frame decoded before a rewind request
+		if (m_isRewind == true)
+		{
+			continue;
+		}
+
+		m_lastTime = frameTime + loopOffset;
+		m_frameArray[slot].time = m_lastTime;
+		m_frameQty++;
+	}
+}
+
+/******************************************************************************
+ m_mutex must be locked
+ *****************************************************************************/
+Uint32 LibavStream::getPlayTime() const
+{
+	if (m_isStarted == false)
+	{
+		return 0U;
+	}
+
+	if (m_isPaused == true)
+	{
+		return m_pausedTime;
+	}
+
+	return sdl_get_global_time() - m_startTick - m_timeOffset;
+}
+
+/******************************************************************************
+ m_mutex must be locked
+ *****************************************************************************/
+void LibavStream::requestRewind()
+{
+	m_frameHead = 0;
+	m_frameQty = 0;
+	m_isRewind = true;
+	m_timeOffset = sdl_get_global_time() - m_startTick;
+	m_pausedTime = 0U;
+
+	m_condition.notify_all();
+}
+
+/*****************************************************************************/
+SDL_Texture * LibavStream::getTexture(const Uint32 startTick, const bool isLoop)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Playback starts when the stream is displayed for the first time.
+	// Later start ticks are ignored, items sharing the stream may have
+	// different ones. rewind() restarts it.
+	if (m_isStarted == false)
+	{
+		m_isStarted = true;
+		m_startTick = startTick;
+		m_timeOffset = sdl_get_global_time() - m_startTick;
+	}
+
+	if (isLoop != m_isLoop)
+	{
+		m_isLoop = isLoop;
+		m_condition.notify_all();
+	}
+
+	Uint32 playTime = getPlayTime();
+
+	// Skip frames which are already late
+	int slot = -1;
+	while ((m_frameQty > 0) && (m_frameArray[m_frameHead].time <= playTime))
+	{
+		slot = m_frameHead;
+		m_frameHead = (m_frameHead + 1) % STREAM_FRAME_QTY;
+		m_frameQty--;
+	}
+
+	if (slot != -1)
+	{
+		// The released slot can't be written by the decoder while the lock is held
+		upload(m_frameArray[slot]);
+		m_condition.notify_all();
+	}
+
+	return m_texture;
+}
+
+/*****************************************************************************/
+void LibavStream::pause()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_isPaused == false)
+	{
+		m_pausedTime = getPlayTime();
+		m_isPaused = true;
+	}
+}
+
+/*****************************************************************************/
+void LibavStream::resume()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_isPaused == true)
+	{
+		m_isPaused = false;
+		m_timeOffset = sdl_get_global_time() - m_startTick - m_pausedTime;
+	}
+}
+
+/*****************************************************************************/
+bool LibavStream::isPaused() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_isPaused;
+}
+
+/*****************************************************************************/
+void LibavStream::rewind()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	requestRewind();
+}
+
+/*****************************************************************************/
+SiAnim * libav_load_stream(const std::string & filePath, const SiLoadOption & option)
+{
+	std::shared_ptr<LibavStream> stream = std::make_shared<LibavStream>();
+
+	if (stream->open(filePath, option) == false)
+	{
+		return nullptr;
+	}
+
+	SiAnim * anim = new SiAnim;
+
+	anim->setWidth(stream->getWidth());
+	anim->setHeight(stream->getHeight());
+	anim->setStream(stream);
+
+	return anim;
+}
@@ -20,10 +20,13 @@
 #ifndef MEDIA_LIBAV_H
 #define MEDIA_LIBAV_H
 
+#include <SDL.h>
 #include <string>
 
 class SiAnim;
+struct SiLoadOption;
 
-SiAnim * libav_load(const std::string & filePath);
+SiAnim * libav_load(const Uint8 * data, const size_t size, const SiLoadOption & option);
+SiAnim * libav_load_stream(const std::string & filePath, const SiLoadOption & option);
 
 #endif // MEDIA_LIBAV_H
@@ -0,0 +1,240 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "si_pack.h"
+#include "SiAnim.h"
+#include <stdio.h>
+#include <string.h>
+
+/*****************************************************************************/
+static Uint64 align(const Uint64 offset)
+{
+	return (offset + PACK_ALIGN - 1U) / PACK_ALIGN * PACK_ALIGN;
+}
+
+/*****************************************************************************/
+static bool write_data(FILE * file, const void * data, const size_t size)
+{
+	return fwrite(data, 1, size, file) == size;
+}
+
+/*****************************************************************************/
+static bool write_padding(FILE * file, const Uint64 offset)
+{
+	static const Uint8 zero[PACK_ALIGN] =
+	{ 0 };
+
+	return write_data(file, zero, (size_t) (align(offset) - offset));
+}
+
+/******************************************************************************
+ Write anim at the current position of file, which is offset
+ return false if error
+ *****************************************************************************/
+static bool write_anim(FILE * file, Uint64 & offset, SiAnim & anim, const Uint32 format)
+{
+	const int frameQty = anim.getFrameQty();
+	const std::vector<Uint32> & delayArray = anim.getDelayArray();
+	std::vector<SDL_Surface *> surfArray;
+	std::vector<SDL_Rect> sourceArray;
+	std::vector<SDL_Surface *> convertedArray;
+	std::vector<PackFrame> frameArray;
+	bool isOk = true;
+
+	PackAnim packAnim;
+	packAnim.width = anim.getWidth();
+	packAnim.height = anim.getHeight();
+	packAnim.frameQty = frameQty;
+	packAnim.unused = 0U;
+
+	// Pixels are stored after the frame table
+	Uint64 pixelOffset = align(offset + sizeof(PackAnim) + frameQty * sizeof(PackFrame));
+
+	for (int i = 0; i < frameQty; i++)
+	{
+		const SDL_Rect & rect = anim.getFrameRect(i);
+		const SDL_Rect & source = anim.getSourceRect(i);
+
+		// Pixels of frames sharing a texture area are stored once
+		int sharedFrame = -1;
+		for (int j = 0; (j < i) && (sharedFrame == -1); j++)
+		{
+			const SDL_Rect & sharedSource = anim.getSourceRect(j);
+			if ((anim.getTexture(j) == anim.getTexture(i)) && (sharedSource.x == source.x) && (sharedSource.y == source.y) && (sharedSource.w == source.w)
+					&& (sharedSource.h == source.h))
+			{
+				sharedFrame = j;
+			}
+		}
+
+		SDL_Surface * surf = nullptr;
+		if (sharedFrame == -1)
+		{
+			surf = anim.getTexture(i)->getSurface();
+		}
+
+		if ((surf != nullptr) && (surf->format->format != format))
+		{
+			surf = SDL_ConvertSurfaceFormat(surf, format, 0);
+			if (surf == nullptr)
+			{
+				isOk = false;
+			}
+			convertedArray.push_back(surf);
+		}
+
+		PackFrame frame;
+		frame.pixelOffset = 0U;
+		frame.delay = 0U;
+		if (i < (int) delayArray.size())
+		{
+			frame.delay = delayArray[i];
+		}
+		frame.keyFrame = anim.getKeyFrame(i);
+		frame.x = rect.x;
+		frame.y = rect.y;
+		frame.width = rect.w;
+		frame.height = rect.h;
+
+		if (surf != nullptr)
+		{
+			frame.pixelOffset = pixelOffset;
+			pixelOffset = align(pixelOffset + (Uint64) source.w * source.h * 4U);
+		}
+		else if (sharedFrame != -1)
+		{
+			frame.pixelOffset = frameArray[sharedFrame].pixelOffset;
+		}
+
+		surfArray.push_back(surf);
+		sourceArray.push_back(source);
+		frameArray.push_back(frame);
+	}
+
+	if (isOk == true)
+	{
+		isOk = write_data(file, &packAnim, sizeof(packAnim));
+	}
+	if ((isOk == true) && (frameQty > 0))
+	{
+		isOk = write_data(file, frameArray.data(), frameQty * sizeof(PackFrame));
+	}
+	offset += sizeof(PackAnim) + frameQty * sizeof(PackFrame);
+
+	for (int i = 0; (i < frameQty) && (isOk == true); i++)
+	{
+		SDL_Surface * surf = surfArray[i];
+		const SDL_Rect & source = sourceArray[i];
+		if (surf == nullptr)
+		{
+			continue;
+		}
+
+		isOk = write_padding(file, offset);
+		offset = align(offset);
+
+		// Only the source area is stored, frames of a sprite sheet share their surface
+		for (int y = source.y; (y < source.y + source.h) && (isOk == true); y++)
+		{
+			isOk = write_data(file, (const Uint8 *) surf->pixels + y * surf->pitch + source.x * 4, source.w * 4);
+		}
+		offset += (Uint64) source.w * source.h * 4U;
+	}
+
+	for (auto && surf : convertedArray)
+	{
+		SDL_FreeSurface(surf);
+	}
+
+	return isOk;
+}
+
+/*****************************************************************************/
+bool pack_write(const std::string & filePath, const std::vector<std::pair<std::string, SiAnim *>> & animArray, const Uint32 format)
+{
+	FILE * file = fopen(filePath.c_str(), "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+
+	PackHeader header;
+	memcpy(header.magic, PACK_MAGIC, sizeof(header.magic));
+	header.version = PACK_VERSION;
+	header.format = format;
+	header.animQty = animArray.size();
+	header.indexOffset = 0U;
+
+	// The header is written again once the index offset is known
+	bool isOk = write_data(file, &header, sizeof(header));
+	Uint64 offset = sizeof(header);
+	std::vector<Uint64> animOffsetArray;
+
+	for (auto && anim : animArray)
+	{
+		if (isOk == false)
+		{
+			break;
+		}
+
+		isOk = write_padding(file, offset);
+		offset = align(offset);
+		animOffsetArray.push_back(offset);
+
+		if (isOk == true)
+		{
+			isOk = write_anim(file, offset, *anim.second, format);
+		}
+	}
+
+	header.indexOffset = offset;
+
+	for (size_t i = 0U; (i < animArray.size()) && (isOk == true); i++)
+	{
+		const std::string & name = animArray[i].first;
+
+		PackIndex index;
+		index.animOffset = animOffsetArray[i];
+		index.nameSize = name.size();
+		index.unused = 0U;
+
+		isOk = write_data(file, &index, sizeof(index));
+		if (isOk == true)
+		{
+			isOk = write_data(file, name.data(), name.size());
+		}
+	}
+
+	if (isOk == true)
+	{
+		isOk = (fseek(file, 0, SEEK_SET) == 0) && write_data(file, &header, sizeof(header));
+	}
+
+	if (fclose(file) != 0)
+	{
+		isOk = false;
+	}
+
+	if (isOk == false)
+	{
+		remove(filePath.c_str());
+	}
+
+	return isOk;
+}
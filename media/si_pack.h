@@ -0,0 +1,89 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef MEDIA_PACK_H
+#define MEDIA_PACK_H
+
+#include <SDL.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class SiAnim;
+
+/******************************************************************************
+ Asset pack file layout. Fields are in host byte order: like the pixel
+ format, a pack is built for the platform it is loaded on.
+
+ PackHeader
+ for each anim, at PackIndex::animOffset:
+   PackAnim
+   PackFrame[frameQty]
+   pixels of each frame at PackFrame::pixelOffset, rows of width * 4 bytes
+ at PackHeader::indexOffset, animQty times:
+   PackIndex followed by nameSize bytes of name
+ *****************************************************************************/
+static constexpr char PACK_MAGIC[4] =
+{ 'S', 'I', 'P', 'K' };
+// 2: delta frames are drawn over their whole key frame
+static constexpr Uint32 PACK_VERSION = 2U;
+// Alignment of frames pixels in the file
+static constexpr Uint64 PACK_ALIGN = 16U;
+
+struct PackHeader
+{
+	char magic[4];
+	Uint32 version;
+	Uint32 format; // SDL pixel format of all frames
+	Uint32 animQty;
+	Uint64 indexOffset;
+};
+
+struct PackIndex
+{
+	Uint64 animOffset;
+	Uint32 nameSize;
+	Uint32 unused;
+};
+
+struct PackAnim
+{
+	Sint32 width;
+	Sint32 height;
+	Uint32 frameQty;
+	Uint32 unused;
+};
+
+struct PackFrame
+{
+	Uint64 pixelOffset; // 0 if the frame has no pixel
+	Uint32 delay;
+	Sint32 keyFrame;
+	Sint32 x;
+	Sint32 y;
+	Sint32 width;
+	Sint32 height;
+};
+
+// anims must have been loaded with SiLoadOption::isNoTexture.
+// Frames are converted to format if needed.
+// return false if error
+bool pack_write(const std::string & filePath, const std::vector<std::pair<std::string, SiAnim *>> & animArray, const Uint32 format);
+
+#endif // MEDIA_PACK_H
@@ -17,7 +17,12 @@
  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
  */
 
+#include "reader.h"
 #include "sdl.h"
+#include "si_file.h"
+#include "si_frame.h"
+#include "si_scale.h"
+#include "si_scratch.h"
 #include "SiAnim.h"
 #include "stdio.h"
 #include <string>
@@ -33,45 +38,46 @@ extern "C"
 }
 #endif
 
+// PNG signature size
+static constexpr size_t MAGIC_SIZE = 8U;
+
 /*****************************************************************************/
-SDL_Texture * libpng_load_texture(const std::string & filePath, int * width_out, int * height_out)
+static void read_data(png_structp png_ptr, png_bytep dest, png_size_t size)
 {
-	FILE *fp = nullptr;
+	MemReader * reader = (MemReader *) png_get_io_ptr(png_ptr);
+
+	if (reader->read(dest, size) != size)
+	{
+		png_error(png_ptr, "Truncated PNG data");
+	}
+}
+
+/*****************************************************************************/
+SDL_Surface * libpng_load_surface(const Uint8 * data, const size_t size, const Uint32 format, const bool isScratch)
+{
+	MemReader reader(data, size);
 	png_structp png_ptr = nullptr;
 	png_infop info_ptr = nullptr;
-	SDL_Surface* surf = nullptr;
-	png_bytep *row_pointers = nullptr;
+	// volatile: still valid after a longjmp to the error handler
+	SDL_Surface * volatile surf = nullptr;
+	png_bytep * row_pointers = nullptr;
 	png_uint_32 width = 0U;
 	png_uint_32 height = 0U;
 	int bit_depth = 0;
 	int color_type = 0;
 	png_uint_32 i = 0U;
-	png_byte magic[8];
-	SDL_Texture * tex = nullptr;
-
-	// open image file
-	fp = fopen(filePath.c_str(), "rb");
-	if (!fp)
-	{
-		//fprintf (stderr, "error: couldn't open \"%s\"!\n", filename);
-		return nullptr;
-	}
-
-	// read magic number
-	fread(magic, 1, sizeof(magic), fp);
 
 	// check for valid magic number
-	if (!png_check_sig(magic, sizeof(magic)))
+	if ((size < MAGIC_SIZE) || (png_sig_cmp(data, 0, MAGIC_SIZE) != 0))
 	{
-		fclose(fp);
 		return nullptr;
 	}
+	reader.seek(MAGIC_SIZE);
 
 	// create a png read struct
 	png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
 	if (png_ptr == nullptr)
 	{
-		fclose(fp);
 		return nullptr;
 	}
 
@@ -80,7 +86,6 @@ SDL_Texture * libpng_load_texture(const std::string & filePath, int * width_out,
 	if (info_ptr == nullptr)
 	{
 		png_destroy_read_struct(&png_ptr, nullptr, nullptr);
-		fclose(fp);
 		return nullptr;
 	}
 
@@ -90,16 +95,19 @@ SDL_Texture * libpng_load_texture(const std::string & filePath, int * width_out,
 	if (setjmp(png_jmpbuf(png_ptr)))
 	{
 		png_destroy_read_struct(&png_ptr, &info_ptr, (png_info **) nullptr);
-		fclose(fp);
+		if (surf != nullptr)
+		{
+			SDL_FreeSurface(surf);
+		}
 		// If we get here, we had a problem reading the file
 		return nullptr;
 	}
 
-	// setup libpng for using standard C fread() function with our FILE pointer
-	png_init_io(png_ptr, fp);
+	// setup libpng to read the bytes in memory
+	png_set_read_fn(png_ptr, &reader, read_data);
 
 	// tell libpng that we have already read the magic number
-	png_set_sig_bytes(png_ptr, sizeof(magic));
+	png_set_sig_bytes(png_ptr, MAGIC_SIZE);
 
 	// read the file information
 	png_read_info(png_ptr, info_ptr);
@@ -144,6 +152,12 @@ SDL_Texture * libpng_load_texture(const std::string & filePath, int * width_out,
 		png_set_gray_to_rgb(png_ptr);
 	}
 
+	// libpng outputs RGBA bytes, swap red and blue for a BGRA renderer
+	if (format == SDL_PIXELFORMAT_BGRA32)
+	{
+		png_set_bgr(png_ptr);
+	}
+
 	// optional call to update the info structure
 	png_read_update_info(png_ptr, info_ptr);
 
@@ -152,54 +166,134 @@ SDL_Texture * libpng_load_texture(const std::string & filePath, int * width_out,
 
 	//wlog(LOGDEBUG,"size: %dx%d bit_depth: %d, type: %d",width,height,bit_depth,color_type);
 	// allocate the memory to hold the image using the fields of png_info.
-	surf = SDL_CreateRGBSurface(0, width, height, 32, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000);
-	memset(surf->pixels, 0, width * height * sizeof(Uint32));
-	row_pointers = (png_bytep *) malloc(sizeof(png_bytep) * height);
+	// png_read_image writes every pixel, no need to clear it first
+	if (isScratch == true)
+	{
+		surf = scratch_create_surface(ScratchSlot::PNG_PIXELS, width, height, format);
+	}
+	else
+	{
+		surf = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, format);
+	}
+	if (surf == nullptr)
+	{
+		png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+		return nullptr;
+	}
+	row_pointers = (png_bytep *) scratch_get(ScratchSlot::PNG_ROWS, sizeof(png_bytep) * height);
 
 	for (i = 0; i < height; i++)
 	{
-		row_pointers[height - i - 1] = (png_bytep) (surf->pixels) + ((height - (i + 1)) * width * sizeof(Uint32));
+		row_pointers[i] = (png_bytep) (surf->pixels) + i * surf->pitch;
 	}
 
 	// the easiest way to read the image
 	png_read_image(png_ptr, row_pointers);
 
-	free(row_pointers);
-
 	// read the rest of the file, getting any additional chunks in info_ptr
 	png_read_end(png_ptr, info_ptr);
 
 	// clean up after the read, and free any memory allocated
 	png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
 
-	// close the file
-	fclose(fp);
+	return surf;
+}
+
+/*****************************************************************************/
+SDL_Texture * libpng_load_texture(const std::string & filePath, int * width_out, int * height_out)
+{
+	FileMap file;
+	if (file.open(filePath) == false)
+	{
+		return nullptr;
+	}
 
-	tex = SDL_CreateTextureFromSurface(sdl_get_renderer(), surf);
-	SDL_FreeSurface(surf);
+	SDL_Surface * surf = libpng_load_surface(file.getData(), file.getSize(), sdl_get_texture_format(), true);
+	if (surf == nullptr)
+	{
+		return nullptr;
+	}
+
+	SDL_Rect rect =
+	{ 0, 0, surf->w, surf->h };
+	SDL_Texture * tex = frame_create_texture(surf, rect);
+
+	*width_out = surf->w;
+	*height_out = surf->h;
 
-	*width_out = width;
-	*height_out = height;
+	SDL_FreeSurface(surf);
 
 	return tex;
 }
 
 /*****************************************************************************/
-SiAnim * libpng_load(const std::string & filePath)
+SiAnim * libpng_load(const Uint8 * data, const size_t size, const SiLoadOption & option)
 {
 	int width = 0;
 	int height = 0;
+	// Pixels are only needed until they are uploaded
+	const bool isScratch = (option.isNoTexture == false) && (option.isLazyTexture == false);
 
-	SDL_Texture * tex = libpng_load_texture(filePath, &width, &height);
-	if (tex == nullptr)
+	SDL_Surface * surf = libpng_load_surface(data, size, sdl_get_texture_format(), isScratch);
+	if (surf == nullptr)
 	{
 		return nullptr;
 	}
 
+	scale_get_size(option, surf->w, surf->h, &width, &height);
+	if ((width != surf->w) || (height != surf->h))
+	{
+		SDL_Surface * scaled = nullptr;
+		if (isScratch == true)
+		{
+			scaled = scratch_create_surface(ScratchSlot::SCALED, width, height, surf->format->format);
+			if (scaled != nullptr)
+			{
+				scale_surface_to(surf, scaled);
+			}
+		}
+		else
+		{
+			scaled = scale_surface(surf, width, height);
+		}
+		SDL_FreeSurface(surf);
+		surf = scaled;
+		if (surf == nullptr)
+		{
+			return nullptr;
+		}
+	}
+
+	SDL_Rect rect =
+	{ 0, 0, width, height };
 	SiAnim * anim = new SiAnim;
 
+	if ((option.isMipmap == true) || (option.isTrim == true))
+	{
+		// Levels and trimmed area are computed from the surface before it is uploaded
+		frame_push(*anim, surf, rect, SiAnim::NO_KEY_FRAME, option);
+		SDL_FreeSurface(surf);
+	}
+	else if ((option.isNoTexture == true) || (option.isLazyTexture == true))
+	{
+		anim->pushSurface(surf, rect, SiAnim::NO_KEY_FRAME);
+	}
+	else
+	{
+		// The surface is already in the renderer format: a single copy to the texture
+		SDL_Texture * tex = frame_create_texture(surf, rect);
+		SDL_FreeSurface(surf);
+
+		if (tex == nullptr)
+		{
+			delete anim;
+			return nullptr;
+		}
+
+		anim->pushTexture(tex, rect, SiAnim::NO_KEY_FRAME);
+	}
+
 	anim->pushDelay(0U);
-	anim->pushTexture(tex);
 	anim->setWidth(width);
 	anim->setHeight(height);
 
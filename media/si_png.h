@@ -20,12 +20,18 @@
 #ifndef MEDIA_PNG_H
 #define MEDIA_PNG_H
 
+#include <SDL.h>
 #include <string>
 
 class SiAnim;
+struct SiLoadOption;
+struct SDL_Surface;
 struct SDL_Texture;
 
+// format is either SDL_PIXELFORMAT_RGBA32 or SDL_PIXELFORMAT_BGRA32.
+// If isScratch is true, pixels are in the thread scratch buffers (see si_scratch.h)
+SDL_Surface * libpng_load_surface(const Uint8 * data, const size_t size, const Uint32 format, const bool isScratch);
 SDL_Texture * libpng_load_texture(const std::string & filePath, int * width_out, int * height_out);
-SiAnim * libpng_load(const std::string & filePath);
+SiAnim * libpng_load(const Uint8 * data, const size_t size, const SiLoadOption & option);
 
 #endif // MEDIA_PNG_H
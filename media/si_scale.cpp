@@ -0,0 +1,275 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "reader.h"
+#include "si_scale.h"
+
+/*****************************************************************************/
+void scale_get_size(const SiLoadOption & option, int sourceWidth, int sourceHeight, int * width, int * height)
+{
+	*width = sourceWidth;
+	*height = sourceHeight;
+
+	if ((sourceWidth <= 0) || (sourceHeight <= 0))
+	{
+		return;
+	}
+
+	if ((option.width > 0) && (option.height > 0))
+	{
+		*width = option.width;
+		*height = option.height;
+	}
+	else if (option.width > 0)
+	{
+		*width = option.width;
+		*height = sourceHeight * option.width / sourceWidth;
+	}
+	else if (option.height > 0)
+	{
+		*width = sourceWidth * option.height / sourceHeight;
+		*height = option.height;
+	}
+	else
+	{
+		*width = sourceWidth * option.scale + 0.5;
+		*height = sourceHeight * option.scale + 0.5;
+	}
+
+	if (*width < 1)
+	{
+		*width = 1;
+	}
+	if (*height < 1)
+	{
+		*height = 1;
+	}
+
+	// Enlarging is left to the renderer
+	if ((*width > sourceWidth) || (*height > sourceHeight))
+	{
+		*width = sourceWidth;
+		*height = sourceHeight;
+	}
+}
+
+// get_alpha_shift() of formats without alpha, such as XRGB8888
+static constexpr int NO_ALPHA = -1;
+
+/******************************************************************************
+ Alpha is the byte selected by Amask, other bytes are averaged as colors.
+ Without Amask all the bytes are colors or padding, averaged unweighted.
+ *****************************************************************************/
+static int get_alpha_shift(SDL_Surface * surf)
+{
+	if (surf->format->Amask == 0x000000ff)
+	{
+		return 0;
+	}
+	else if (surf->format->Amask == 0x0000ff00)
+	{
+		return 8;
+	}
+	else if (surf->format->Amask == 0x00ff0000)
+	{
+		return 16;
+	}
+	else if (surf->format->Amask == 0xff000000)
+	{
+		return 24;
+	}
+
+	return NO_ALPHA;
+}
+
+/******************************************************************************
+ Box filter: each destination pixel is the average of the source pixels it
+ covers. Colors are weighted by alpha so that transparent pixels don't
+ darken edges, surfaces without alpha are averaged unweighted.
+ *****************************************************************************/
+SDL_Surface * scale_surface(SDL_Surface * surf, int width, int height)
+{
+	SDL_Surface * scaled = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, surf->format->format);
+	if (scaled == nullptr)
+	{
+		return nullptr;
+	}
+
+	scale_surface_to(surf, scaled);
+
+	return scaled;
+}
+
+/*****************************************************************************/
+void scale_surface_to(SDL_Surface * surf, SDL_Surface * scaled)
+{
+	const int width = scaled->w;
+	const int height = scaled->h;
+
+	const int alphaShift = get_alpha_shift(surf);
+
+	for (int y = 0; y < height; y++)
+	{
+		const int top = y * surf->h / height;
+		int bottom = (y + 1) * surf->h / height;
+		if (bottom <= top)
+		{
+			bottom = top + 1;
+		}
+
+		Uint32 * dest = (Uint32 *) ((Uint8 *) scaled->pixels + y * scaled->pitch);
+
+		for (int x = 0; x < width; x++)
+		{
+			const int left = x * surf->w / width;
+			int right = (x + 1) * surf->w / width;
+			if (right <= left)
+			{
+				right = left + 1;
+			}
+
+			Uint64 sum[4] =
+			{ 0U, 0U, 0U, 0U };
+			Uint32 alphaSum = 0U;
+
+			for (int sy = top; sy < bottom; sy++)
+			{
+				const Uint32 * source = (const Uint32 *) ((const Uint8 *) surf->pixels + sy * surf->pitch);
+				for (int sx = left; sx < right; sx++)
+				{
+					const Uint32 pixel = source[sx];
+					const Uint32 alpha = (alphaShift == NO_ALPHA) ? 1U : (pixel >> alphaShift) & 0xff;
+					alphaSum += alpha;
+					for (int c = 0; c < 4; c++)
+					{
+						sum[c] += ((pixel >> (c * 8)) & 0xff) * alpha;
+					}
+				}
+			}
+
+			const Uint32 count = (bottom - top) * (right - left);
+			Uint32 pixel = 0U;
+			if (alphaSum != 0U)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					pixel |= (Uint32) (sum[c] / alphaSum) << (c * 8);
+				}
+			}
+			if (alphaShift != NO_ALPHA)
+			{
+				pixel &= ~(0xffU << alphaShift);
+				pixel |= (alphaSum / count) << alphaShift;
+			}
+
+			dest[x] = pixel;
+		}
+	}
+}
+
+/*****************************************************************************/
+SDL_Rect scale_rect(const SDL_Rect & rect, int sourceWidth, int sourceHeight, int width, int height)
+{
+	SDL_Rect scaled =
+	{ 0, 0, 0, 0 };
+
+	scaled.x = rect.x * width / sourceWidth;
+	scaled.y = rect.y * height / sourceHeight;
+	scaled.w = ((rect.x + rect.w) * width + sourceWidth - 1) / sourceWidth - scaled.x;
+	scaled.h = ((rect.y + rect.h) * height + sourceHeight - 1) / sourceHeight - scaled.y;
+
+	return scaled;
+}
+
+/******************************************************************************
+ 2x2 box filter, weighted by alpha like scale_surface. The last column and
+ row of odd sized surfaces are averaged with themselves.
+ The inner loop only uses integer operations on independent pixels so that
+ the compiler can vectorize it.
+ *****************************************************************************/
+void scale_half_to(SDL_Surface * surf, SDL_Surface * half)
+{
+	const int alphaShift = get_alpha_shift(surf);
+
+	for (int y = 0; y < half->h; y++)
+	{
+		const int y0 = y * 2;
+		const int y1 = (y0 + 1 < surf->h) ? y0 + 1 : y0;
+		const Uint32 * line0 = (const Uint32 *) ((const Uint8 *) surf->pixels + y0 * surf->pitch);
+		const Uint32 * line1 = (const Uint32 *) ((const Uint8 *) surf->pixels + y1 * surf->pitch);
+		Uint32 * dest = (Uint32 *) ((Uint8 *) half->pixels + y * half->pitch);
+
+		for (int x = 0; x < half->w; x++)
+		{
+			const int x0 = x * 2;
+			const int x1 = (x0 + 1 < surf->w) ? x0 + 1 : x0;
+			const Uint32 source[4] =
+			{ line0[x0], line0[x1], line1[x0], line1[x1] };
+
+			Uint32 sum[4] =
+			{ 0U, 0U, 0U, 0U };
+			Uint32 alphaSum = 0U;
+
+			for (int i = 0; i < 4; i++)
+			{
+				const Uint32 alpha = (alphaShift == NO_ALPHA) ? 1U : (source[i] >> alphaShift) & 0xff;
+				alphaSum += alpha;
+				for (int c = 0; c < 4; c++)
+				{
+					sum[c] += ((source[i] >> (c * 8)) & 0xff) * alpha;
+				}
+			}
+
+			Uint32 pixel = 0U;
+			if (alphaSum != 0U)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					pixel |= (sum[c] / alphaSum) << (c * 8);
+				}
+			}
+			if (alphaShift != NO_ALPHA)
+			{
+				pixel &= ~(0xffU << alphaShift);
+				pixel |= (alphaSum / 4U) << alphaShift;
+			}
+
+			dest[x] = pixel;
+		}
+	}
+}
+
+/*****************************************************************************/
+SDL_Rect scale_half_rect(const SDL_Rect & rect)
+{
+	SDL_Rect half =
+	{ 0, 0, 0, 0 };
+
+	if (SDL_RectEmpty(&rect) == SDL_TRUE)
+	{
+		return half;
+	}
+
+	half.x = rect.x / 2;
+	half.y = rect.y / 2;
+	half.w = (rect.x + rect.w + 1) / 2 - half.x;
+	half.h = (rect.y + rect.h + 1) / 2 - half.y;
+
+	return half;
+}
@@ -0,0 +1,43 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef MEDIA_SCALE_H
+#define MEDIA_SCALE_H
+
+#include <SDL.h>
+
+struct SiLoadOption;
+
+// Size of a sourceWidth x sourceHeight frame once loaded with option
+void scale_get_size(const SiLoadOption & option, int sourceWidth, int sourceHeight, int * width, int * height);
+
+// Shrink a 32 bits per pixel surface. The returned surface has the same pixel format.
+SDL_Surface * scale_surface(SDL_Surface * surf, int width, int height);
+// Same as scale_surface, into an existing surface of the same pixel format
+void scale_surface_to(SDL_Surface * surf, SDL_Surface * scaled);
+
+// Half size copy of surf into half, which is (surf->w + 1) / 2 x (surf->h + 1) / 2
+void scale_half_to(SDL_Surface * surf, SDL_Surface * half);
+// Pixels of the half size surface computed from rect
+SDL_Rect scale_half_rect(const SDL_Rect & rect);
+
+// Smallest rect of the shrunk surface containing all pixels computed from rect
+SDL_Rect scale_rect(const SDL_Rect & rect, int sourceWidth, int sourceHeight, int width, int height);
+
+#endif // MEDIA_SCALE_H
@@ -0,0 +1,55 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "si_scratch.h"
+#include <vector>
+
+static thread_local std::vector<Uint8> scratchArray[(int) ScratchSlot::QTY];
+
+/*****************************************************************************/
+Uint8 * scratch_get(const ScratchSlot slot, const size_t size)
+{
+	std::vector<Uint8> & scratch = scratchArray[(int) slot];
+
+	// Buffers only grow, so that bulk loads settle without allocation
+	if (scratch.size() < size)
+	{
+		scratch.resize(size);
+	}
+
+	return scratch.data();
+}
+
+/*****************************************************************************/
+SDL_Surface * scratch_create_surface(const ScratchSlot slot, const int width, const int height, const Uint32 format)
+{
+	const int pitch = width * 4;
+	Uint8 * pixels = scratch_get(slot, (size_t) pitch * height);
+
+	return SDL_CreateRGBSurfaceWithFormatFrom(pixels, width, height, 32, pitch, format);
+}
+
+/*****************************************************************************/
+void scratch_release()
+{
+	for (auto && scratch : scratchArray)
+	{
+		std::vector<Uint8>().swap(scratch);
+	}
+}
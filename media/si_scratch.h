@@ -0,0 +1,42 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef MEDIA_SCRATCH_H
+#define MEDIA_SCRATCH_H
+
+#include <SDL.h>
+
+// Decode buffers kept by each thread and reused from one load to the next.
+// Buffers used at the same time by a decoder must be in different slots.
+enum class ScratchSlot
+{
+	CANVAS, PREVIOUS_CANVAS, KEY_FRAME, SCALED, MIPMAP_EVEN, MIPMAP_ODD, GIF_LINE, PNG_ROWS, PNG_PIXELS, ZIP_ENTRY, VIDEO_FRAME, QTY
+};
+
+// Return at least size bytes, with undefined content.
+// They are valid until the next call for the same slot on this thread.
+Uint8 * scratch_get(const ScratchSlot slot, const size_t size);
+
+// Surface whose pixels are the slot buffer. Free it with SDL_FreeSurface.
+SDL_Surface * scratch_create_surface(const ScratchSlot slot, const int width, const int height, const Uint32 format);
+
+// Free the buffers of the calling thread
+void scratch_release();
+
+#endif // MEDIA_SCRATCH_H
@@ -0,0 +1,249 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "reader.h"
+#include "sdl.h"
+#include "si_frame.h"
+#include "si_json.h"
+#include "si_png.h"
+#include "si_sheet.h"
+#include "SiAnim.h"
+#include "SiTexture.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+
+// Used when a frame of the table has no duration
+static constexpr Uint32 DEFAULT_TABLE_DELAY = 100U;
+
+/******************************************************************************
+ Decode the sheet and create the texture shared by all frames
+ return nullptr if error
+ *****************************************************************************/
+static std::shared_ptr<SiTexture> load_sheet(const Uint8 * data, const size_t size, const SiLoadOption & option, int * width, int * height)
+{
+	// Pixels are only needed until they are uploaded
+	const bool isScratch = (option.isNoTexture == false) && (option.isLazyTexture == false);
+
+	SDL_Surface * surf = libpng_load_surface(data, size, sdl_get_texture_format(), isScratch);
+	if (surf == nullptr)
+	{
+		return nullptr;
+	}
+
+	*width = surf->w;
+	*height = surf->h;
+
+	if (isScratch == false)
+	{
+		return std::make_shared<SiTexture>(surf);
+	}
+
+	SDL_Rect rect =
+	{ 0, 0, surf->w, surf->h };
+	SDL_Texture * tex = frame_create_texture(surf, rect);
+	SDL_FreeSurface(surf);
+
+	if (tex == nullptr)
+	{
+		return nullptr;
+	}
+
+	return std::make_shared<SiTexture>(tex);
+}
+
+/*****************************************************************************/
+static bool is_inside(const SDL_Rect & rect, const int width, const int height)
+{
+	return (rect.x >= 0) && (rect.y >= 0) && (rect.w >= 0) && (rect.h >= 0) && (rect.x + rect.w <= width) && (rect.y + rect.h <= height);
+}
+
+/*****************************************************************************/
+SiAnim * sheet_load_grid(const Uint8 * data, const size_t size, const SiSheetGrid & grid, const SiLoadOption & option)
+{
+	int sheetWidth = 0;
+	int sheetHeight = 0;
+
+	if ((grid.frameWidth <= 0) || (grid.frameHeight <= 0) || (grid.spacing < 0) || (grid.margin < 0))
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<SiTexture> texture = load_sheet(data, size, option, &sheetWidth, &sheetHeight);
+	if (texture == nullptr)
+	{
+		return nullptr;
+	}
+
+	const int columnQty = (sheetWidth - 2 * grid.margin + grid.spacing) / (grid.frameWidth + grid.spacing);
+	const int rowQty = (sheetHeight - 2 * grid.margin + grid.spacing) / (grid.frameHeight + grid.spacing);
+	int frameQty = std::max(columnQty, 0) * std::max(rowQty, 0);
+
+	if (grid.frameQty > 0)
+	{
+		if (grid.frameQty > frameQty)
+		{
+			return nullptr;
+		}
+		frameQty = grid.frameQty;
+	}
+
+	if (frameQty == 0)
+	{
+		return nullptr;
+	}
+
+	SiAnim * anim = new SiAnim;
+	anim->setWidth(grid.frameWidth);
+	anim->setHeight(grid.frameHeight);
+
+	SDL_Rect rect =
+	{ 0, 0, grid.frameWidth, grid.frameHeight };
+
+	for (int i = 0; i < frameQty; i++)
+	{
+		SDL_Rect source =
+		{ 0, 0, grid.frameWidth, grid.frameHeight };
+		source.x = grid.margin + (i % columnQty) * (grid.frameWidth + grid.spacing);
+		source.y = grid.margin + (i / columnQty) * (grid.frameHeight + grid.spacing);
+
+		anim->pushTextureArea(texture, source, rect);
+		anim->pushDelay(grid.delay);
+	}
+
+	return anim;
+}
+
+/******************************************************************************
+ Read the x, y, w and h members of value
+ *****************************************************************************/
+static SDL_Rect read_rect(const JsonValue & value)
+{
+	SDL_Rect rect =
+	{ 0, 0, 0, 0 };
+
+	rect.x = (int) value.getNumber("x", 0.0);
+	rect.y = (int) value.getNumber("y", 0.0);
+	rect.w = (int) value.getNumber("w", 0.0);
+	rect.h = (int) value.getNumber("h", 0.0);
+
+	return rect;
+}
+
+/*****************************************************************************/
+SiAnim * sheet_load_table(const Uint8 * data, const size_t size, const char * table, const size_t tableSize, const SiLoadOption & option)
+{
+	JsonValue root;
+	std::vector<const JsonValue *> entryArray;
+
+	if (json_parse(table, tableSize, root) == false)
+	{
+		return nullptr;
+	}
+
+	// Frames are either an array or an object whose members are named after the frames
+	const JsonValue * frames = root.get("frames");
+	if (frames == nullptr)
+	{
+		return nullptr;
+	}
+	if (frames->type == JsonValue::Type::ARRAY)
+	{
+		for (auto && entry : frames->array)
+		{
+			entryArray.push_back(&entry);
+		}
+	}
+	else if (frames->type == JsonValue::Type::OBJECT)
+	{
+		for (auto && member : frames->object)
+		{
+			entryArray.push_back(&member.second);
+		}
+	}
+
+	if (entryArray.empty() == true)
+	{
+		return nullptr;
+	}
+
+	int sheetWidth = 0;
+	int sheetHeight = 0;
+	std::shared_ptr<SiTexture> texture = load_sheet(data, size, option, &sheetWidth, &sheetHeight);
+	if (texture == nullptr)
+	{
+		return nullptr;
+	}
+
+	SiAnim * anim = new SiAnim;
+	int width = 0;
+	int height = 0;
+
+	for (auto && entry : entryArray)
+	{
+		const JsonValue * frame = entry->get("frame");
+		const JsonValue * rotated = entry->get("rotated");
+		const JsonValue * spriteSourceSize = entry->get("spriteSourceSize");
+		const JsonValue * sourceSize = entry->get("sourceSize");
+
+		// Rotated frames are not supported
+		if ((frame == nullptr) || ((rotated != nullptr) && (rotated->type == JsonValue::Type::BOOLEAN) && (rotated->boolean == true)))
+		{
+			delete anim;
+			return nullptr;
+		}
+
+		SDL_Rect source = read_rect(*frame);
+		if (is_inside(source, sheetWidth, sheetHeight) == false)
+		{
+			delete anim;
+			return nullptr;
+		}
+
+		// Trimmed frames only cover part of the anim
+		SDL_Rect rect =
+		{ 0, 0, source.w, source.h };
+		if (spriteSourceSize != nullptr)
+		{
+			rect.x = (int) spriteSourceSize->getNumber("x", 0.0);
+			rect.y = (int) spriteSourceSize->getNumber("y", 0.0);
+		}
+		if ((rect.x < 0) || (rect.y < 0))
+		{
+			delete anim;
+			return nullptr;
+		}
+
+		width = std::max(width, rect.x + rect.w);
+		height = std::max(height, rect.y + rect.h);
+		if (sourceSize != nullptr)
+		{
+			width = std::max(width, (int) sourceSize->getNumber("w", 0.0));
+			height = std::max(height, (int) sourceSize->getNumber("h", 0.0));
+		}
+
+		anim->pushTextureArea(texture, source, rect);
+		anim->pushDelay((Uint32) std::max(entry->getNumber("duration", DEFAULT_TABLE_DELAY), 0.0));
+	}
+
+	anim->setWidth(width);
+	anim->setHeight(height);
+
+	return anim;
+}
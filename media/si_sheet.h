@@ -0,0 +1,34 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#ifndef MEDIA_SHEET_H
+#define MEDIA_SHEET_H
+
+#include <SDL.h>
+
+class SiAnim;
+struct SiLoadOption;
+struct SiSheetGrid;
+
+// data is a PNG sprite sheet, all frames share its texture
+SiAnim * sheet_load_grid(const Uint8 * data, const size_t size, const SiSheetGrid & grid, const SiLoadOption & option);
+// table is a JSON frame table in the Aseprite / TexturePacker "frames" format
+SiAnim * sheet_load_table(const Uint8 * data, const size_t size, const char * table, const size_t tableSize, const SiLoadOption & option);
+
+#endif // MEDIA_SHEET_H
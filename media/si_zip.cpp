@@ -17,9 +17,15 @@
  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
  */
 
+#include "reader.h"
+#include "sdl.h"
+#include "si_frame.h"
 #include "si_png.h"
+#include "si_scale.h"
+#include "si_scratch.h"
 #include "SiAnim.h"
 #include "stdio.h"
+#include "stdlib.h"
 #include <algorithm>
 #include <string>
 #include <vector>
@@ -30,90 +36,76 @@ extern "C"
 }
 
 const std::string ZIP_TIMING_FILE = "timing";
-const std::string ZIP_TMP_FILE = "/tmp/si_tmp";
 
 static constexpr int DEFAULT_DELAY_MS = 40;
 
 /*****************************************************************************/
-static void read_timing(const std::string & filePath, int timingQuantity, std::vector<Uint32> & delayArray)
+static void read_timing(const Uint8 * data, const size_t size, int timingQuantity, std::vector<Uint32> & delayArray)
 {
-	FILE * file = nullptr;
-	file = fopen(filePath.c_str(), "r");
+	const std::string text((const char *) data, size);
+	const char * cursor = text.c_str();
 
 	int i = 0;
 	for (i = 0; i < timingQuantity; i++)
 	{
-		Uint32 delay = 0;
-		fscanf(file, "%d", &delay);
+		char * end = nullptr;
+		Uint32 delay = strtoul(cursor, &end, 10);
 		delayArray.push_back(delay);
+		cursor = end;
 	}
-	fclose(file);
 }
 
-/*****************************************************************************/
-static int extract_zip(struct zip *fdZip, int index)
+/******************************************************************************
+ Uncompress file at index in the ZIP_ENTRY scratch buffer
+ return nullptr if error
+ *****************************************************************************/
+static const Uint8 * read_entry(struct zip *fdZip, int index, size_t * size)
 {
 	struct zip_stat fileStat;
 	struct zip_file *fileZip = nullptr;
-	char * data;
-	FILE *file_dest;
 
 	zip_stat_index(fdZip, index, 0, &fileStat);
 
-	fileZip = zip_fopen(fdZip, fileStat.name, ZIP_FL_UNCHANGED);
+	fileZip = zip_fopen_index(fdZip, index, ZIP_FL_UNCHANGED);
 	if (fileZip == 0)
 	{
-		return -1;
-	}
-
-	data = (char*) malloc((size_t) (fileStat.size));
-	if (zip_fread(fileZip, data, (size_t) (fileStat.size)) != (int64_t) fileStat.size)
-	{
-		free(data);
-		zip_fclose(fileZip);
-		return -1;
-	}
-
-	file_dest = fopen(ZIP_TMP_FILE.c_str(), "wb");
-	if (file_dest == nullptr)
-	{
-		free(data);
-		zip_fclose(fileZip);
-		return -1;
+		return nullptr;
 	}
 
-	if (fwrite(data, sizeof(char), (size_t) fileStat.size, file_dest) != fileStat.size)
+	Uint8 * data = scratch_get(ScratchSlot::ZIP_ENTRY, (size_t) (fileStat.size));
+	if (zip_fread(fileZip, data, fileStat.size) != (zip_int64_t) fileStat.size)
 	{
-		fclose(file_dest);
-		free(data);
 		zip_fclose(fileZip);
-		return -1;
+		return nullptr;
 	}
 
-	fclose(file_dest);
-	free(data);
 	zip_fclose(fileZip);
 
-	return 0;
+	*size = (size_t) (fileStat.size);
+
+	return data;
 }
 
 /*****************************************************************************/
-SiAnim * libzip_load(const std::string & filePath)
+SiAnim * libzip_load(const Uint8 * data, const size_t size, const SiLoadOption & option)
 {
-	int err = 0;
-	struct zip * fdZip = zip_open(filePath.c_str(), ZIP_CHECKCONS, &err);
+	zip_error_t error;
+	zip_error_init(&error);
 
-	if (err != ZIP_ER_OK)
+	// The archive is read in place, without copy
+	zip_source_t * source = zip_source_buffer_create(data, size, 0, &error);
+	if (source == nullptr)
 	{
-#if 0
-		zip_error_to_str(buf_erreur, sizeof buf_erreur, err, errno);
-		printf("Error %d : %s\n",err, buf_erreur);
-#endif
+		zip_error_fini(&error);
 		return nullptr;
 	}
 
+	struct zip * fdZip = zip_open_from_source(source, ZIP_CHECKCONS | ZIP_RDONLY, &error);
+	zip_error_fini(&error);
+
 	if (fdZip == nullptr)
 	{
+		zip_source_free(source);
 		return nullptr;
 	}
 
@@ -147,6 +139,7 @@ SiAnim * libzip_load(const std::string & filePath)
 
 	// Read file in archive and process them (either as PNG file or timing file
 	int index = 0;
+	FrameEncoder encoder(*anim, option);
 
 	for (auto && zipFileName : zipFileNameArray)
 	{
@@ -156,8 +149,9 @@ SiAnim * libzip_load(const std::string & filePath)
 			continue;
 		}
 
-		// Create ZIP_TMP_FILE file
-		if (extract_zip(fdZip, index) < 0)
+		size_t entrySize = 0U;
+		const Uint8 * entry = read_entry(fdZip, index, &entrySize);
+		if (entry == nullptr)
 		{
 			continue;
 		}
@@ -167,21 +161,51 @@ SiAnim * libzip_load(const std::string & filePath)
 		// timing file
 		if (zipFileName == ZIP_TIMING_FILE)
 		{
-			read_timing(ZIP_TMP_FILE, fileQty - 1, delayArray);
+			read_timing(entry, entrySize, fileQty - 1, delayArray);
 			anim->setDelayArray(delayArray);
 			continue;
 		}
 
 		// PNG file
+		// The encoder copies what it keeps, decoded pixels can be reused by next frame
+		SDL_Surface * surf = libpng_load_surface(entry, entrySize, sdl_get_texture_format(), true);
+		if (surf == nullptr)
+		{
+			anim->pushEmptyFrame();
+			continue;
+		}
+
 		int width = 0;
 		int height = 0;
-		anim->pushTexture(libpng_load_texture(ZIP_TMP_FILE, &width, &height));
-		anim->setWidth(width);
-		anim->setHeight(height);
+		scale_get_size(option, surf->w, surf->h, &width, &height);
+		if ((width != surf->w) || (height != surf->h))
+		{
+			SDL_Surface * scaled = scratch_create_surface(ScratchSlot::SCALED, width, height, surf->format->format);
+			if (scaled != nullptr)
+			{
+				scale_surface_to(surf, scaled);
+			}
+			SDL_FreeSurface(surf);
+			surf = scaled;
+			if (surf == nullptr)
+			{
+				anim->pushEmptyFrame();
+				continue;
+			}
+		}
+
+		// Frames are compared to the previous key frame to only store what changed
+		encoder.push(surf, nullptr);
+		anim->setWidth(surf->w);
+		anim->setHeight(surf->h);
+
+		SDL_FreeSurface(surf);
 	}
 
 	// Clean-up
 	zip_close(fdZip);
 
+	SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "ZIP: %llu bytes of texture saved by delta frames", (unsigned long long) encoder.getSavedBytes());
+
 	return anim;
 }
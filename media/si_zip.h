@@ -20,10 +20,11 @@
 #ifndef MEDIA_ZIP_H
 #define MEDIA_ZIP_H
 
-#include <string>
+#include <SDL.h>
 
 class SiAnim;
+struct SiLoadOption;
 
-SiAnim * libzip_load(const std::string & filePath);
+SiAnim * libzip_load(const Uint8 * data, const size_t size, const SiLoadOption & option);
 
 #endif // MEDIA_ZIP_H
@@ -20,9 +20,13 @@
 #include "reader.h"
 #include "sdl.h"
 #include "SdlItem.h"
+#include "SdlItemContext.h"
 #include "SiAnim.h"
+#include "SiJobSystem.h"
 #include "SiKeyCallback.h"
 #include "SiMouseEvent.h"
+#include "tracker.h"
+#include <algorithm>
 #include <assert.h>
 #include <functional>
 #include <iostream>
@@ -30,39 +34,127 @@
 #include <string>
 #include <vector>
 
-static int fullscreen = 0;
+// Current context of each thread, the default one if nullptr
+static thread_local SdlItemContext * currentContext = nullptr;
 
-static std::function<void(std::string)> keyboard_text_cb;
-static SdlItem * focusedItem = nullptr;
+static constexpr int DEFAULT_SCREEN_W = 1024;
+static constexpr int DEFAULT_SCREEN_H = 768;
 
-static int virtual_x = 0;
-static int virtual_y = 0;
-static double virtual_z = 1.0;
-static int old_vx = 0;
-static int old_vy = 0;
-static double old_vz = 1.0;
-static int current_vx = 0;
-static int current_vy = 0;
-static double currentVz = 1.0;
-static Uint32 virtual_tick = 0;
-static int mouseX = 0;
-static int mouseY = 0;
-static bool isAppHasFocus = false;
-static Uint32 globalTick;
+static constexpr Uint32 TEXTURE_RELEASE_PERIOD = 1000U;
 
-static std::vector<struct SiKeyCallback> keyCbArray;
-static std::vector<struct SiMouseEvent> globalMouseEventArray;
+// Items per chunk of the parallel stages
+static constexpr int ITEM_CHUNK_SIZE = 1024;
 
-static SDL_Window * window = nullptr;
-static SDL_Renderer * renderer = nullptr;
+// Camera, viewport and mouse the draw list and hover state of a frame are
+// computed from, read on the render thread before jobs use them
+struct View
+{
+	double x; // virtual position in pixels
+	double y;
+	int originX; // viewport position in the renderer output
+	int originY;
+	int width; // viewport size
+	int height;
+	double zoom;
+	int mouseX; // relative to the viewport
+	int mouseY;
+	bool isMouseIn; // the mouse is over the viewport
+	Uint32 tick; // global tick of the frame
+	double stepAlpha; // 1 to draw items at their current position
+	bool isPixelSnap; // whole pixel positions and sizes
+};
+
+enum class DrawKind
+{
+	TEXTURE, // copy of a texture
+	STREAM, // anim of the item index which is a stream
+	TEXT // text of the item index
+};
+
+// Built by any thread, submitted in order by the render thread which is the
+// only one creating textures and drawing streams and texts
+struct DrawCmd
+{
+	DrawKind kind;
+	SiTexture * siTexture; // texture created when submitted, or nullptr
+	SDL_Texture * texture; // used if siTexture is nullptr
+	bool isSource; // false to copy the whole texture
+	SDL_Rect source;
+	SDL_FRect dest; // on screen, item coordinate of a STREAM
+	SDL_FPoint center;
+	double angle;
+	int flip;
+	const SiAnim * anim; // STREAM
+	int index; // STREAM and TEXT
+};
+
+// Reused from one frame to the next by each render thread, jobs are given
+// references to the lists of the thread they work for
+static thread_local std::vector<DrawCmd> immediateDrawList; // sdl_blit_tex() and sdl_blit_anim()
+static thread_local std::vector<DrawCmd> itemDrawList; // sdl_blit_item()
+static thread_local std::vector<std::vector<DrawCmd>> chunkDrawListArray; // sdl_blit_store()
+static thread_local std::vector<SiItemHandle> mouseHandleArray; // sdl_mouse_manager()
 
-static constexpr int DEFAULT_SCREEN_W = 1024;
-static constexpr int DEFAULT_SCREEN_H = 768;
+/*****************************************************************************/
+static SdlItemContext::State & get_state()
+{
+	if (currentContext == nullptr)
+	{
+		return SdlItemContext::getDefault().getState();
+	}
+
+	return currentContext->getState();
+}
+
+/******************************************************************************
+ Following sdl_* calls from this thread use context, the default one if
+ context is nullptr
+ *****************************************************************************/
+void sdl_set_context(SdlItemContext * context)
+{
+	currentContext = context;
+}
+
+/*****************************************************************************/
+SdlItemContext & sdl_get_context()
+{
+	if (currentContext == nullptr)
+	{
+		return SdlItemContext::getDefault();
+	}
+
+	return *currentContext;
+}
 
 /*****************************************************************************/
 SDL_Renderer * sdl_get_renderer()
 {
-	return renderer;
+	return get_state().renderer;
+}
+
+/******************************************************************************
+ Return the 32 bits RGBA format textures are stored in by the renderer, so
+ that pixels can be uploaded without conversion
+ *****************************************************************************/
+Uint32 sdl_get_texture_format()
+{
+	SdlItemContext::State & state = get_state();
+
+	SDL_RendererInfo info;
+	if (SDL_GetRendererInfo(state.renderer, &info) < 0)
+	{
+		return SDL_PIXELFORMAT_RGBA32;
+	}
+
+	for (Uint32 i = 0U; i < info.num_texture_formats; i++)
+	{
+		if ((info.texture_formats[i] == SDL_PIXELFORMAT_RGBA32) || (info.texture_formats[i] == SDL_PIXELFORMAT_BGRA32))
+		{
+			return info.texture_formats[i];
+		}
+	}
+
+	return SDL_PIXELFORMAT_RGBA32;
 }
 
 /*****************************************************************************/
@@ -88,25 +180,33 @@ void sdl_cleanup()
 	SDL_Quit();
 }
 
-/*****************************************************************************/
+/******************************************************************************
+ Create the window and renderer of the current context. SDL is initialized
+ by the first call and shared by all contexts.
+ *****************************************************************************/
 void sdl_init(const std::string & title, const bool vsync)
 {
-	if (SDL_Init(SDL_INIT_EVERYTHING) < 0)
-	{
-		exit(EXIT_FAILURE);
-	}
+	SdlItemContext::State & state = get_state();
 
-	if (TTF_Init() == -1)
+	if (SDL_WasInit(SDL_INIT_VIDEO) == 0)
 	{
-		exit(EXIT_FAILURE);
-	}
+		if (SDL_Init(SDL_INIT_EVERYTHING) < 0)
+		{
+			exit(EXIT_FAILURE);
+		}
+
+		if (TTF_Init() == -1)
+		{
+			exit(EXIT_FAILURE);
+		}
 
-	atexit(sdl_cleanup);
+		atexit(sdl_cleanup);
+	}
 
-	window = SDL_CreateWindow(title.c_str(),
+	state.window = SDL_CreateWindow(title.c_str(),
 	SDL_WINDOWPOS_UNDEFINED,
 	SDL_WINDOWPOS_UNDEFINED, DEFAULT_SCREEN_W, DEFAULT_SCREEN_H, SDL_WINDOW_RESIZABLE);
-	if (window == nullptr)
+	if (state.window == nullptr)
 	{
 		exit(EXIT_FAILURE);
 	}
@@ -117,29 +217,157 @@ void sdl_init(const std::string & title, const bool vsync)
 		flags |= SDL_RENDERER_PRESENTVSYNC;
 	}
 
-	renderer = SDL_CreateRenderer(window, -1, flags);
-	if (renderer == nullptr)
+	state.renderer = SDL_CreateRenderer(state.window, -1, flags);
+	if (state.renderer == nullptr)
 	{
 		exit(EXIT_FAILURE);
 	}
 
-	SDL_RenderSetLogicalSize(renderer, DEFAULT_SCREEN_W, DEFAULT_SCREEN_H);
+	SDL_RenderSetLogicalSize(state.renderer, DEFAULT_SCREEN_W, DEFAULT_SCREEN_H);
 	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
 }
 
 /*****************************************************************************/
 void sdl_init_screen()
 {
-	focusedItem = nullptr;
+	SdlItemContext::State & state = get_state();
+
+	state.focusedStore = nullptr;
+	state.focusedItem = SiItemStore::NO_ITEM;
+}
+
+/******************************************************************************
+ Camera centered in its viewport, the whole renderer output if it is empty
+ *****************************************************************************/
+static void get_view(const SdlItemContext::State & state, const SiCamera & camera, View & view)
+{
+	const SDL_Rect & viewport = camera.getViewport();
+
+	view.originX = 0;
+	view.originY = 0;
+	if (SDL_RectEmpty(&viewport) == SDL_TRUE)
+	{
+		SDL_GetRendererOutputSize(state.renderer, &view.width, &view.height);
+	}
+	else
+	{
+		view.originX = viewport.x;
+		view.originY = viewport.y;
+		view.width = viewport.w;
+		view.height = viewport.h;
+	}
+
+	view.zoom = camera.getCurrentZoom();
+	view.x = (view.width / view.zoom / 2) - camera.getCurrentX();
+	view.y = (view.height / view.zoom / 2) - camera.getCurrentY();
+	view.mouseX = state.mouseX - view.originX;
+	view.mouseY = state.mouseY - view.originY;
+	view.isMouseIn = true;
+	if (SDL_RectEmpty(&viewport) == SDL_FALSE)
+	{
+		view.isMouseIn = (0 <= view.mouseX) && (view.mouseX < view.width) && (0 <= view.mouseY) && (view.mouseY < view.height);
+	}
+	view.tick = state.globalTick;
+	view.isPixelSnap = state.isPixelSnap;
+	view.stepAlpha = 1.0;
+	if (state.stepRate != 0)
+	{
+		view.stepAlpha = state.stepAlpha;
+	}
+}
+
+/******************************************************************************
+ View of the default camera
+ *****************************************************************************/
+static void get_view(const SdlItemContext::State & state, View & view)
+{
+	get_view(state, state.camera, view);
+}
+
+/******************************************************************************
+ Position of an item interpolated between the last two fixed time steps
+ *****************************************************************************/
+static void get_item_pos(const View & view, const SiItemStore & store, const int index, double & x, double & y)
+{
+	const SDL_Rect & rect = store.getRectArray()[index];
+
+	x = rect.x;
+	y = rect.y;
+
+	if ((view.stepAlpha >= 1.0) || (store.isFlag(index, SiItemStore::FLAG_SNAP) == true))
+	{
+		return;
+	}
+
+	const SDL_Point & previous = store.getPreviousPosArray()[index];
+	x = previous.x + (double) (rect.x - previous.x) * view.stepAlpha;
+	y = previous.y + (double) (rect.y - previous.y) * view.stepAlpha;
+}
+
+/******************************************************************************
+ Return true if the mouse is over item index of store.
+ mx and my are the mouse position in the item's coordinates
+ *****************************************************************************/
+static bool is_mouse_over(const SiItemStore & store, const int index, const View & view, int & mx, int & my)
+{
+	const SDL_Rect & rect = store.getRectArray()[index];
+	int zoomedX = 0;
+	int zoomedY = 0;
+	int zoomedW = 0;
+	int zoomedH = 0;
+	// Where the item is drawn
+	double itemX = 0.0;
+	double itemY = 0.0;
+
+	// Items are only hit in the viewport they are drawn in
+	if (view.isMouseIn == false)
+	{
+		return false;
+	}
+
+	get_item_pos(view, store, index, itemX, itemY);
+
+	if (store.isFlag(index, SiItemStore::FLAG_OVERLAY) == true)
+	{
+		mx = view.mouseX;
+		my = view.mouseY;
+		zoomedX = itemX;
+		zoomedY = itemY;
+		zoomedW = rect.w;
+		zoomedH = rect.h;
+	}
+	else
+	{
+		mx = view.mouseX - (view.x * view.zoom);
+		my = view.mouseY - (view.y * view.zoom);
+		zoomedX = itemX * view.zoom;
+		zoomedY = itemY * view.zoom;
+		zoomedW = rect.w * view.zoom;
+		zoomedH = rect.h * view.zoom;
+	}
+
+	return (zoomedX <= mx) && (mx < (zoomedX + zoomedW)) && (zoomedY <= my) && (my < (zoomedY + zoomedH));
 }
 
 /*****************************************************************************/
-static void get_virtual(SDL_Renderer * renderer, int & virtual_x_px, int & virtual_y_px, int & width_px, int & height_px)
+static void mouse_position_item(SiItemStore & store, const int index, const View & view, const bool isButtonDown)
 {
-	SDL_GetRendererOutputSize(renderer, &width_px, &height_px);
+	int mx = 0;
+	int my = 0;
+
+	store.getAnim(index, SiItemStore::AnimSet::OVER).clear();
+	store.getAnim(index, SiItemStore::AnimSet::CLICK).clear();
 
-	virtual_x_px = (width_px / currentVz / 2) - current_vx;
-	virtual_y_px = (height_px / currentVz / 2) - current_vy;
+	if (is_mouse_over(store, index, view, mx, my) == true)
+	{
+		store.getAnim(index, SiItemStore::AnimSet::OVER) = store.getAnim(index, SiItemStore::AnimSet::DEFAULT_OVER);
+
+		// Display clicked anim
+		if (isButtonDown == true)
+		{
+			store.getAnim(index, SiItemStore::AnimSet::CLICK) = store.getAnim(index, SiItemStore::AnimSet::DEFAULT_CLICK);
+		}
+	}
 }
 
 /*****************************************************************************/
@@ -152,217 +380,280 @@ void sdl_mouse_position_manager(std::vector<SdlItem *> & itemArray)
 	 }
 	 */
 
+	View view;
+	get_view(get_state(), view);
+	const bool isButtonDown = SDL_GetMouseState(nullptr, nullptr) != 0;
+
+	for (auto && item : itemArray)
+	{
+		SiItemStore & store = item->getStore();
+		mouse_position_item(store, store.getIndex(item->getHandle()), view, isButtonDown);
+	}
+}
+
+/*****************************************************************************/
+void sdl_mouse_position_manager(SiItemStore & store)
+{
+	sdl_mouse_position_manager(store, get_state().camera);
+}
+
+/******************************************************************************
+ Items are checked in parallel chunks, each one only writing its own items
+ *****************************************************************************/
+void sdl_mouse_position_manager(SiItemStore & store, const SiCamera & camera)
+{
+	View view;
+	get_view(get_state(), camera, view);
+	const bool isButtonDown = SDL_GetMouseState(nullptr, nullptr) != 0;
+
+	SiJobSystem::getDefault().parallelFor(store.getQty(), ITEM_CHUNK_SIZE, [&](int chunk, int begin, int end)
+	{
+		for (int index = begin; index < end; index++)
+		{
+			mouse_position_item(store, index, view, isButtonDown);
+		}
+	});
+}
+
+/******************************************************************************
+ Manage event for item index of store if the mouse is over it
+ return true if the mouse is over the item
+ *****************************************************************************/
+static bool mouse_item(SDL_Event * event, SiItemStore & store, const int index, const bool isOverlay, const View & view)
+{
+	SdlItemContext::State & state = get_state();
+
 	int mx = 0;
 	int my = 0;
-	int vx = 0;
-	int vy = 0;
-	int width = 0;
-	int height = 0;
-	int zoomedX = 0;
-	int zoomedY = 0;
-	int zoomedW = 0;
-	int zoomedH = 0;
 
-	for (auto && item : itemArray)
+	if (store.isFlag(index, SiItemStore::FLAG_OVERLAY) != isOverlay)
+	{
+		return false;
+	}
+
+	if (is_mouse_over(store, index, view, mx, my) == false)
+	{
+		return false;
+	}
+
+	const SiItemHandle handle = store.getHandle(index);
+	const Uint32 flags = store.getFlagArray()[index];
+	// Called last, it may create or destroy items
+	std::function<void()> callBack;
+	// Handler bit matching the event, the handler table is only read if it is bound
+	Uint32 handlerFlag = 0;
+
+	switch (event->type)
 	{
-		if (item->isOverlay() == true)
+	case SDL_MOUSEMOTION:
+		if ((flags & SiItemStore::HANDLER_OVER) != 0)
 		{
-			mx = mouseX;
-			my = mouseY;
-			zoomedX = item->getRect().x;
-			zoomedY = item->getRect().y;
-			zoomedW = item->getRect().w;
-			zoomedH = item->getRect().h;
+			double itemX = 0.0;
+			double itemY = 0.0;
+			get_item_pos(view, store, index, itemX, itemY);
+			const std::function<void(int x, int y)> overCb = store.findHandlers(handle)->overCb;
+			/* x,y is the mouse pointer position relative to the item itself.
+			 i.e. 0,0 is the mouse pointer is in the upper-left corner of the item */
+			overCb(mx - itemX, my - itemY);
 		}
-		else
+		break;
+	case SDL_MOUSEBUTTONDOWN:
+		state.focusedStore = nullptr;
+		state.focusedItem = SiItemStore::NO_ITEM;
+
+		if ((flags & SiItemStore::FLAG_EDITABLE) != 0)
 		{
-			get_virtual(renderer, vx, vy, width, height);
-			mx = mouseX - (vx * currentVz);
-			my = mouseY - (vy * currentVz);
-			zoomedX = item->getRect().x * currentVz;
-			zoomedY = item->getRect().y * currentVz;
-			zoomedW = item->getRect().w * currentVz;
-			zoomedH = item->getRect().h * currentVz;
+			state.focusedStore = &store;
+			state.focusedItem = handle;
 		}
 
-		item->clearAnimOver();
-		item->clearAnimClick();
+		if (((flags & SiItemStore::HANDLER_CLICK_LEFT) != 0) && (event->button.button == SDL_BUTTON_LEFT))
+		{
+			store.setFlag(index, SiItemStore::FLAG_CLICKED, true);
+		}
+		if (((flags & SiItemStore::HANDLER_CLICK_RIGHT) != 0) && (event->button.button == SDL_BUTTON_RIGHT))
+		{
+			store.setFlag(index, SiItemStore::FLAG_CLICKED, true);
+		}
+		break;
+	case SDL_MOUSEBUTTONUP:
+		store.setFlag(index, SiItemStore::FLAG_CLICKED, false);
 
-		if ((zoomedX <= mx) && ((zoomedX + zoomedW) > mx) && (zoomedY <= my) && ((zoomedY + zoomedH) > my))
+		if ((event->button.button == SDL_BUTTON_LEFT) && (event->button.clicks == 1))
+		{
+			handlerFlag = SiItemStore::HANDLER_CLICK_LEFT;
+		}
+		if ((event->button.button == SDL_BUTTON_RIGHT) && (event->button.clicks == 1))
+		{
+			handlerFlag = SiItemStore::HANDLER_CLICK_RIGHT;
+		}
+		if ((event->button.button == SDL_BUTTON_LEFT) && (event->button.clicks == 2))
+		{
+			handlerFlag = SiItemStore::HANDLER_DOUBLE_CLICK_LEFT;
+		}
+		if ((event->button.button == SDL_BUTTON_RIGHT) && (event->button.clicks == 2))
+		{
+			handlerFlag = SiItemStore::HANDLER_DOUBLE_CLICK_RIGHT;
+		}
+		break;
+	case SDL_MOUSEWHEEL:
+		if (event->wheel.timestamp == state.wheelTimeStamp)
+		{
+			break;
+		}
+		if ((event->wheel.y > 0) && ((flags & SiItemStore::HANDLER_WHEEL_UP) != 0))
 		{
-			item->setAnimOver(item->getDefaultAnimOver());
+			state.wheelTimeStamp = event->wheel.timestamp;
+			handlerFlag = SiItemStore::HANDLER_WHEEL_UP;
+		}
+		if ((event->wheel.y < 0) && ((flags & SiItemStore::HANDLER_WHEEL_DOWN) != 0))
+		{
+			state.wheelTimeStamp = event->wheel.timestamp;
+			handlerFlag = SiItemStore::HANDLER_WHEEL_DOWN;
+		}
+		break;
+	}
 
-			// Display clicked anim
-			if (SDL_GetMouseState(nullptr, nullptr))
-			{
-				item->setAnimClick(item->getDefaultAnimClick());
-			}
+	if ((flags & handlerFlag) != 0)
+	{
+		const SiItemStore::Handlers * handlers = store.findHandlers(handle);
+
+		switch (handlerFlag)
+		{
+		case SiItemStore::HANDLER_CLICK_LEFT:
+			callBack = handlers->clickLeftCb;
+			break;
+		case SiItemStore::HANDLER_CLICK_RIGHT:
+			callBack = handlers->clickRightCb;
+			break;
+		case SiItemStore::HANDLER_DOUBLE_CLICK_LEFT:
+			callBack = handlers->doubleClickLeftCb;
+			break;
+		case SiItemStore::HANDLER_DOUBLE_CLICK_RIGHT:
+			callBack = handlers->doubleClickRightCb;
+			break;
+		case SiItemStore::HANDLER_WHEEL_UP:
+			callBack = handlers->wheelUpCb;
+			break;
+		case SiItemStore::HANDLER_WHEEL_DOWN:
+			callBack = handlers->wheelDownCb;
+			break;
 		}
 	}
+
+	if (bool(callBack) == true)
+	{
+		callBack();
+	}
+
+	return true;
 }
 
 /*****************************************************************************/
-bool sdl_mouse_manager_with_overlay(SDL_Event * event, std::vector<SdlItem *> & itemArray, bool isOverlay, Uint32 & timeStamp)
+bool sdl_mouse_manager_with_overlay(SDL_Event * event, std::vector<SdlItem *> & itemArray, bool isOverlay)
 {
-	int mx = 0;
-	int my = 0;
-	int zoomedX = 0;
-	int zoomedY = 0;
-	int zoomedW = 0;
-	int zoomedH = 0;
-	focusedItem = nullptr;
+	SdlItemContext::State & state = get_state();
 
-	int vx = 0;
-	int vy = 0;
-	int width = 0;
-	int height = 0;
-	get_virtual(renderer, vx, vy, width, height);
+	state.focusedStore = nullptr;
+	state.focusedItem = SiItemStore::NO_ITEM;
+
+	View view;
+	get_view(state, view);
 
 	bool itemFound = false;
 
 	for (auto && item : itemArray)
 	{
-		if (item->isOverlay() == true)
+		SiItemStore & store = item->getStore();
+		if (mouse_item(event, store, store.getIndex(item->getHandle()), isOverlay, view) == true)
 		{
-			if (isOverlay == false)
-			{
-				continue;
-			}
-			mx = mouseX;
-			my = mouseY;
-			zoomedX = item->getRect().x;
-			zoomedY = item->getRect().y;
-			zoomedW = item->getRect().w;
-			zoomedH = item->getRect().h;
+			itemFound = true;
 		}
-		else
+	}
+
+	return itemFound;
+}
+
+/*****************************************************************************/
+static bool mouse_store_with_overlay(SDL_Event * event, SiItemStore & store, const View & view, bool isOverlay)
+{
+	SdlItemContext::State & state = get_state();
+
+	state.focusedStore = nullptr;
+	state.focusedItem = SiItemStore::NO_ITEM;
+
+	bool itemFound = false;
+
+	// Callbacks may create or destroy items, which moves other items.
+	// Items existing before the event get it in creation order, those
+	// destroyed meanwhile are skipped.
+	mouseHandleArray.clear();
+	for (auto && index : store.getOrderArray())
+	{
+		mouseHandleArray.push_back(store.getHandle(index));
+	}
+
+	for (size_t i = 0; i < mouseHandleArray.size(); i++)
+	{
+		const SiItemHandle handle = mouseHandleArray[i];
+
+		if (store.isValid(handle) == false)
 		{
-			if (isOverlay == true)
-			{
-				continue;
-			}
-			mx = mouseX - (vx * currentVz);
-			my = mouseY - (vy * currentVz);
-			zoomedX = item->getRect().x * currentVz;
-			zoomedY = item->getRect().y * currentVz;
-			zoomedW = item->getRect().w * currentVz;
-			zoomedH = item->getRect().h * currentVz;
+			continue;
 		}
 
-		// Manage event related to mouse position
-		if ((zoomedX <= mx) && (mx < (zoomedX + zoomedW)) && (zoomedY <= my) && (my < (zoomedY + zoomedH)))
+		if (mouse_item(event, store, store.getIndex(handle), isOverlay, view) == true)
 		{
-			if ((item->isOverlay() == true) && (isOverlay == true))
-			{
-				itemFound = true;
-			}
 			itemFound = true;
-
-			switch (event->type)
-			{
-			case SDL_MOUSEMOTION:
-				if (bool(item->getOverCb()) == true)
-				{
-					/* x,y is the mouse pointer position relative to the item itself.
-					 i.e. 0,0 is the mouse pointer is in the upper-left corner of the item */
-					item->getOverCb()(mx - item->getRect().x, my - item->getRect().y);
-				}
-				break;
-			case SDL_MOUSEBUTTONDOWN:
-				focusedItem = nullptr;
-
-				if (item->isEditable() == true)
-				{
-					focusedItem = item;
-				}
-
-				if ((bool(item->getClickLeftCb()) == true) && (event->button.button == SDL_BUTTON_LEFT))
-				{
-					item->setClicked(true);
-				}
-				if ((bool(item->getClickRightCb()) == true) && (event->button.button == SDL_BUTTON_RIGHT))
-				{
-					item->setClicked(true);
-				}
-				break;
-			case SDL_MOUSEBUTTONUP:
-				item->setClicked(false);
-				if ((bool(item->getClickLeftCb()) == true) && (event->button.button == SDL_BUTTON_LEFT) && (event->button.clicks == 1))
-				{
-					item->getClickLeftCb()();
-				}
-				if ((bool(item->getClickRightCb()) == true) && (event->button.button == SDL_BUTTON_RIGHT) && (event->button.clicks == 1))
-				{
-					item->getClickRightCb()();
-				}
-				if ((bool(item->getDoubleClickLeftCb()) == true) && (event->button.button == SDL_BUTTON_LEFT) && (event->button.clicks == 2))
-				{
-					item->getDoubleClickLeftCb()();
-				}
-				if ((bool(item->getDoubleClickRightCb()) == true) && (event->button.button == SDL_BUTTON_RIGHT) && (event->button.clicks == 2))
-				{
-					item->getDoubleClickRightCb()();
-				}
-				break;
-			case SDL_MOUSEWHEEL:
-				if (event->wheel.timestamp != timeStamp)
-				{
-					if ((event->wheel.y > 0) && (bool(item->getWheelUpCb()) == true))
-					{
-						timeStamp = event->wheel.timestamp;
-						item->getWheelUpCb()();
-					}
-					if ((event->wheel.y < 0) && (bool(item->getWheelDownCb()) == true))
-					{
-						timeStamp = event->wheel.timestamp;
-						item->getWheelDownCb()();
-					}
-				}
-				break;
-			}
 		}
 	}
 
 	return itemFound;
 }
 
-/*****************************************************************************/
-bool sdl_mouse_manager(SDL_Event * event, std::vector<SdlItem *> & itemArray)
+/******************************************************************************
+ Update mouse state from event
+ return false if the application has not the focus
+ *****************************************************************************/
+static bool mouse_update(SDL_Event * event)
 {
-	static Uint32 timeStamp = 0;
+	SdlItemContext::State & state = get_state();
 
 	if (event->type == SDL_WINDOWEVENT)
 	{
 		switch (event->window.event)
 		{
 		case SDL_WINDOWEVENT_ENTER:
-			isAppHasFocus = true;
+			state.isAppHasFocus = true;
 			break;
 		case SDL_WINDOWEVENT_LEAVE:
-			isAppHasFocus = false;
+			state.isAppHasFocus = false;
 			break;
 		default:
 			break;
 		}
 	}
 
-	if (isAppHasFocus == false)
+	if (state.isAppHasFocus == false)
 	{
 		return false;
 	}
 
 	if (event->type == SDL_MOUSEMOTION)
 	{
-		mouseX = event->motion.x;
-		mouseY = event->motion.y;
+		state.mouseX = event->motion.x;
+		state.mouseY = event->motion.y;
 	}
 
-	if (sdl_mouse_manager_with_overlay(event, itemArray, true, timeStamp) == false)
-	{
-		sdl_mouse_manager_with_overlay(event, itemArray, false, timeStamp);
-	}
+	return true;
+}
 
-	for (auto && mouseEvent : globalMouseEventArray)
+/*****************************************************************************/
+static void mouse_global_callback(SDL_Event * event)
+{
+	SdlItemContext::State & state = get_state();
+
+	for (auto && mouseEvent : state.mouseEventArray)
 	{
 		switch (event->type)
 		{
@@ -392,7 +683,7 @@ bool sdl_mouse_manager(SDL_Event * event, std::vector<SdlItem *> & itemArray)
 			{
 				continue;
 			}
-			if (event->wheel.timestamp != timeStamp)
+			if (event->wheel.timestamp != state.wheelTimeStamp)
 			{
 				if ((event->wheel.y > 0) && (mouseEvent.getEventType() == MOUSE_WHEEL_UP))
 				{
@@ -406,6 +697,49 @@ bool sdl_mouse_manager(SDL_Event * event, std::vector<SdlItem *> & itemArray)
 			break;
 		}
 	}
+}
+
+/*****************************************************************************/
+bool sdl_mouse_manager(SDL_Event * event, std::vector<SdlItem *> & itemArray)
+{
+	if (mouse_update(event) == false)
+	{
+		return false;
+	}
+
+	if (sdl_mouse_manager_with_overlay(event, itemArray, true) == false)
+	{
+		sdl_mouse_manager_with_overlay(event, itemArray, false);
+	}
+
+	mouse_global_callback(event);
+
+	return false;
+}
+
+/*****************************************************************************/
+bool sdl_mouse_manager(SDL_Event * event, SiItemStore & store)
+{
+	return sdl_mouse_manager(event, store, get_state().camera);
+}
+
+/*****************************************************************************/
+bool sdl_mouse_manager(SDL_Event * event, SiItemStore & store, const SiCamera & camera)
+{
+	if (mouse_update(event) == false)
+	{
+		return false;
+	}
+
+	View view;
+	get_view(get_state(), camera, view);
+
+	if (mouse_store_with_overlay(event, store, view, true) == false)
+	{
+		mouse_store_with_overlay(event, store, view, false);
+	}
+
+	mouse_global_callback(event);
 
 	return false;
 }
@@ -416,6 +750,8 @@ bool sdl_mouse_manager(SDL_Event * event, std::vector<SdlItem *> & itemArray)
  *****************************************************************************/
 int sdl_screen_manager(SDL_Event * event)
 {
+	SdlItemContext::State & state = get_state();
+
 	const Uint8 *keystate = nullptr;
 
 	switch (event->type)
@@ -424,7 +760,7 @@ int sdl_screen_manager(SDL_Event * event)
 		switch (event->window.event)
 		{
 		case SDL_WINDOWEVENT_RESIZED:
-			SDL_RenderSetLogicalSize(renderer, event->window.data1, event->window.data2);
+			SDL_RenderSetLogicalSize(state.renderer, event->window.data1, event->window.data2);
 			return 1;
 		}
 		break;
@@ -436,15 +772,15 @@ int sdl_screen_manager(SDL_Event * event)
 
 			if (keystate[SDL_SCANCODE_RALT] || keystate[SDL_SCANCODE_LALT])
 			{
-				if (!fullscreen)
+				if (!state.fullscreen)
 				{
-					fullscreen = SDL_WINDOW_FULLSCREEN_DESKTOP;
+					state.fullscreen = SDL_WINDOW_FULLSCREEN_DESKTOP;
 				}
 				else
 				{
-					fullscreen = 0;
+					state.fullscreen = 0;
 				}
-				SDL_SetWindowFullscreen(window, fullscreen);
+				SDL_SetWindowFullscreen(state.window, state.fullscreen);
 				break;
 			}
 			break;
@@ -462,112 +798,424 @@ int sdl_screen_manager(SDL_Event * event)
 	return 0;
 }
 
+/******************************************************************************
+ Apply the commands pushed by other threads
+ *****************************************************************************/
+static void execute_commands(SiCommandQueue & queue)
+{
+	SiCommandQueue::Command command;
+
+	while (queue.pop(command) == true)
+	{
+		if (command.type == SiCommandQueue::Type::CAMERA)
+		{
+			sdl_set_virtual_x(command.x);
+			sdl_set_virtual_y(command.y);
+			sdl_set_virtual_z(command.z);
+			continue;
+		}
+
+		if (command.store->isValid(command.handle) == false)
+		{
+			continue;
+		}
+
+		const int index = command.store->getIndex(command.handle);
+		SDL_Rect & rect = command.store->getRect(index);
+
+		switch (command.type)
+		{
+		case SiCommandQueue::Type::POSITION:
+			rect.x = command.x;
+			rect.y = command.y;
+			break;
+		case SiCommandQueue::Type::ANIM:
+		{
+			std::vector<SiAnim*> & animArray = command.store->getAnim(index, SiItemStore::AnimSet::DEFAULT);
+			animArray.clear();
+			animArray.push_back(command.anim);
+			rect.w = command.anim->getWidth();
+			rect.h = command.anim->getHeight();
+		}
+			break;
+		case SiCommandQueue::Type::TEXT:
+		{
+			// The texture of the previous text is rendered again when drawn
+			SiItemStore::Extra & extra = command.store->getExtra(command.handle);
+			tracker_destroy_texture(extra.textTexture);
+			extra.textTexture = nullptr;
+			command.store->setText(command.handle, command.text);
+		}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/*****************************************************************************/
+static void save_camera_steps(SdlItemContext::State & state)
+{
+	state.camera.saveStep();
+	for (auto && camera : state.cameraArray)
+	{
+		camera->saveStep();
+	}
+}
+
+/******************************************************************************
+ Run the fixed time steps due since the last frame, then interpolate the
+ cameras between the last two steps
+ *****************************************************************************/
+static void run_steps(SdlItemContext::State & state)
+{
+	const Uint64 counter = SDL_GetPerformanceCounter();
+	const double stepDuration = 1.0 / (double) state.stepRate;
+
+	if (state.stepCounter != 0U)
+	{
+		state.stepLag += (double) (counter - state.stepCounter) / (double) SDL_GetPerformanceFrequency();
+	}
+	state.stepCounter = counter;
+
+	// The callback may change the step settings
+	const std::function<void()> stepCb = state.stepCb;
+	int stepQty = 0;
+
+	while ((state.stepLag >= stepDuration) && (stepQty < state.maxStepQty))
+	{
+		for (auto && store : state.stepStoreArray)
+		{
+			store->savePositions();
+		}
+		save_camera_steps(state);
+
+		if (bool(stepCb) == true)
+		{
+			stepCb();
+		}
+
+		state.stepLag -= stepDuration;
+		stepQty++;
+	}
+
+	// Too late to catch up, the simulation slows down instead
+	if (state.stepLag >= stepDuration)
+	{
+		state.stepLag = fmod(state.stepLag, stepDuration);
+	}
+
+	state.stepAlpha = state.stepLag / stepDuration;
+
+	state.camera.interpolateStep(state.stepAlpha);
+	for (auto && camera : state.cameraArray)
+	{
+		camera->interpolateStep(state.stepAlpha);
+	}
+}
+
 /*****************************************************************************/
 void sdl_loop_manager()
 {
-	static Uint32 oldTimer = 0U;
+	SdlItemContext::State & state = get_state();
 
-	if (oldTimer == 0)
+	if (state.oldTimer == 0)
 	{
-		oldTimer = SDL_GetTicks();
+		state.oldTimer = SDL_GetTicks();
 	}
 
-	globalTick = SDL_GetTicks();
+	state.globalTick = SDL_GetTicks();
+
+	// Before the camera update, so that camera commands start moving it now
+	execute_commands(sdl_get_context().getCommandQueue());
+
+	if (state.globalTick - state.textureReleaseTick >= TEXTURE_RELEASE_PERIOD)
+	{
+		state.textureReleaseTick = state.globalTick;
+		SiTexture::releaseUnused(sdl_get_context(), state.globalTick, state.textureReleaseDelay);
+	}
 #if 0
-	if( timer < oldTimer + FRAME_DELAY )
+	if( timer < state.oldTimer + FRAME_DELAY )
 	{
-		SDL_Delay(oldTimer + FRAME_DELAY - timer);
+		SDL_Delay(state.oldTimer + FRAME_DELAY - timer);
 	}
 #endif
 
-	if (virtual_tick + VIRTUAL_CAMERA_ANIM_DURATION > globalTick)
+	if (state.stepRate != 0)
+	{
+		run_steps(state);
+	}
+	else
+	{
+		state.camera.update(state.globalTick);
+		for (auto && camera : state.cameraArray)
+		{
+			camera->update(state.globalTick);
+		}
+	}
+}
+
+/******************************************************************************
+ Compute the on-screen rect of a sprite
+ return false if the sprite is out of screen
+ *****************************************************************************/
+static bool get_screen_rect(const View & view, const SDL_FRect & rect, double zoom_x, double zoom_y, int overlay, SDL_FRect & r)
+{
+	if (view.isPixelSnap == true)
 	{
-		current_vx = (int) ((double) old_vx + (double) (virtual_x - old_vx) * (double) (globalTick - virtual_tick) / (double) VIRTUAL_CAMERA_ANIM_DURATION);
-		current_vy = (int) ((double) old_vy + (double) (virtual_y - old_vy) * (double) (globalTick - virtual_tick) / (double) VIRTUAL_CAMERA_ANIM_DURATION);
-		currentVz = (double) old_vz + (double) (virtual_z - old_vz) * (double) (globalTick - virtual_tick) / (double) VIRTUAL_CAMERA_ANIM_DURATION;
+		SDL_Rect snap =
+		{ (int) lround(rect.x), (int) lround(rect.y), (int) rect.w, (int) rect.h };
+
+		if (overlay == 0)
+		{
+			snap.x += (int) view.x;
+			snap.y += (int) view.y;
+		}
+
+		// Sprite zoom
+		snap.w *= zoom_x;
+		snap.h *= zoom_y;
+
+		if (overlay == 0)
+		{
+			// Virtual zoom
+			snap.x = ceil((double) snap.x * view.zoom);
+			snap.y = ceil((double) snap.y * view.zoom);
+			snap.w = ceil((double) snap.w * view.zoom);
+			snap.h = ceil((double) snap.h * view.zoom);
+		}
+
+		r.x = snap.x;
+		r.y = snap.y;
+		r.w = snap.w;
+		r.h = snap.h;
 	}
 	else
 	{
-		old_vx = virtual_x;
-		current_vx = virtual_x;
+		double x = rect.x;
+		double y = rect.y;
+		double w = rect.w * zoom_x;
+		double h = rect.h * zoom_y;
+
+		if (overlay == 0)
+		{
+			x = (x + view.x) * view.zoom;
+			y = (y + view.y) * view.zoom;
+			w *= view.zoom;
+			h *= view.zoom;
+		}
 
-		old_vy = virtual_y;
-		current_vy = virtual_y;
+		r.x = x;
+		r.y = y;
+		r.w = w;
+		r.h = h;
+	}
 
-		old_vz = virtual_z;
-		currentVz = virtual_z;
+	// Crop
+	if ((r.x > view.width) || ((r.x + r.w) < 0) || (r.y > view.height) || ((r.y + r.h) < 0))
+	{
+		return false;
 	}
+
+	r.x += view.originX;
+	r.y += view.originY;
+
+	return true;
+}
+
+/*****************************************************************************/
+static DrawCmd make_draw_cmd(const DrawKind kind)
+{
+	DrawCmd cmd =
+	{ kind, nullptr, nullptr, false,
+	{ 0, 0, 0, 0 },
+	{ 0, 0, 0, 0 },
+	{ 0, 0 }, 0.0, SDL_FLIP_NONE, nullptr, 0 };
+
+	return cmd;
 }
 
 /******************************************************************************
- flip is one of SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL
+ Push the copy of the src area of a texture (the whole texture if src is
+ nullptr) in rect. The texture is siTexture, or texture if siTexture is nullptr.
  *****************************************************************************/
-void sdl_blit_tex(SDL_Texture * tex, SDL_Rect * rect, double angle, double zoom_x, double zoom_y, int flip, int overlay)
+static void push_tex_area(std::vector<DrawCmd> & drawList, const View & view, SiTexture * siTexture, SDL_Texture * texture, const SDL_Rect * src,
+		const SDL_FRect & rect, double angle, double zoom_x, double zoom_y, int flip, int overlay)
 {
-	SDL_Rect r =
+	if ((siTexture == nullptr) && (texture == nullptr))
+	{
+		return;
+	}
+
+	DrawCmd cmd = make_draw_cmd(DrawKind::TEXTURE);
+
+	if (get_screen_rect(view, rect, zoom_x, zoom_y, overlay, cmd.dest) == false)
+	{
+		return;
+	}
+
+	cmd.siTexture = siTexture;
+	cmd.texture = texture;
+	if (src != nullptr)
+	{
+		cmd.isSource = true;
+		cmd.source = *src;
+	}
+	// Same as SDL's default center
+	cmd.center.x = cmd.dest.w / 2.0f;
+	cmd.center.y = cmd.dest.h / 2.0f;
+	cmd.angle = angle;
+	cmd.flip = flip;
+
+	drawList.push_back(cmd);
+}
+
+/******************************************************************************
+ Push the copy of the src area of siTexture, which covers the part area of an
+ anim of animWidth x animHeight pixels, the whole anim being displayed in rect.
+ Rotation and flip are the ones of the whole anim.
+ *****************************************************************************/
+static void push_tex_part(std::vector<DrawCmd> & drawList, const View & view, SiTexture * siTexture, const SDL_Rect & src, const SDL_Rect & part,
+		int animWidth, int animHeight, const SDL_FRect & rect, double angle, double zoom_x, double zoom_y, int flip, int overlay)
+{
+	SDL_FRect r =
 	{ 0, 0, 0, 0 };
-	int vx = 0;
-	int vy = 0;
-	int width_px = 0;
-	int height_px = 0;
 
-	if (tex == nullptr)
+	if ((siTexture == nullptr) || (animWidth == 0) || (animHeight == 0))
+	{
+		return;
+	}
+
+	if (get_screen_rect(view, rect, zoom_x, zoom_y, overlay, r) == false)
 	{
 		return;
 	}
 
-	get_virtual(renderer, vx, vy, width_px, height_px);
+	int left = part.x;
+	int right = part.x + part.w;
+	int top = part.y;
+	int bottom = part.y + part.h;
+
+	if (flip & SDL_FLIP_HORIZONTAL)
+	{
+		left = animWidth - (part.x + part.w);
+		right = animWidth - part.x;
+	}
+	if (flip & SDL_FLIP_VERTICAL)
+	{
+		top = animHeight - (part.y + part.h);
+		bottom = animHeight - part.y;
+	}
+
+	DrawCmd cmd = make_draw_cmd(DrawKind::TEXTURE);
+	cmd.siTexture = siTexture;
+	cmd.isSource = true;
+	cmd.source = src;
 
-	if (overlay == 1)
+	// Edges are computed from the whole anim so that adjacent parts never overlap
+	if (view.isPixelSnap == true)
 	{
-		r.x = rect->x;
-		r.y = rect->y;
+		const int x = r.x;
+		const int y = r.y;
+		const int w = r.w;
+		const int h = r.h;
+		const int destX = x + left * w / animWidth;
+		const int destY = y + top * h / animHeight;
+
+		cmd.dest.x = destX;
+		cmd.dest.y = destY;
+		cmd.dest.w = x + right * w / animWidth - destX;
+		cmd.dest.h = y + bottom * h / animHeight - destY;
+		cmd.center.x = x + w / 2 - destX;
+		cmd.center.y = y + h / 2 - destY;
 	}
 	else
 	{
-		r.x = rect->x + vx;
-		r.y = rect->y + vy;
+		cmd.dest.x = r.x + left * r.w / animWidth;
+		cmd.dest.y = r.y + top * r.h / animHeight;
+		cmd.dest.w = r.x + right * r.w / animWidth - cmd.dest.x;
+		cmd.dest.h = r.y + bottom * r.h / animHeight - cmd.dest.y;
+		cmd.center.x = r.x + r.w / 2.0f - cmd.dest.x;
+		cmd.center.y = r.y + r.h / 2.0f - cmd.dest.y;
 	}
+	cmd.angle = angle;
+	cmd.flip = flip;
 
-	r.w = rect->w;
-	r.h = rect->h;
+	drawList.push_back(cmd);
+}
 
-	// Sprite zoom
-	r.w *= zoom_x;
-	r.h *= zoom_y;
+/******************************************************************************
+ Draw a TEXTURE command, its texture is created here if needed
+ *****************************************************************************/
+static void submit_tex(const DrawCmd & cmd)
+{
+	SdlItemContext::State & state = get_state();
 
-	if (overlay == 0)
+	SDL_Texture * texture = cmd.texture;
+	if (cmd.siTexture != nullptr)
 	{
-		// Virtual zoom
-		r.x = ceil((double) r.x * currentVz);
-		r.y = ceil((double) r.y * currentVz);
-		r.w = ceil((double) r.w * currentVz);
-		r.h = ceil((double) r.h * currentVz);
+		texture = cmd.siTexture->getTexture();
 	}
 
-	// Crop
-	if ((r.x > width_px) || ((r.x + r.w) < 0) || (r.y > height_px) || ((r.y + r.h) < 0))
+	if (texture == nullptr)
 	{
 		return;
 	}
 
-	if (tex != nullptr)
-	{
-		if (SDL_RenderCopyEx(renderer, tex, nullptr, &r, angle, nullptr, (SDL_RendererFlip) flip) < 0)
-		{
-			//Error
-		}
-	}
+	if (SDL_RenderCopyExF(state.renderer, texture, cmd.isSource ? &cmd.source : nullptr, &cmd.dest, cmd.angle, &cmd.center, (SDL_RendererFlip) cmd.flip) < 0)
+	{
+		//Error
+	}
+}
+
+/*****************************************************************************/
+static SDL_FRect make_frect(const SDL_Rect & rect)
+{
+	SDL_FRect frect =
+	{ (float) rect.x, (float) rect.y, (float) rect.w, (float) rect.h };
+
+	return frect;
+}
+
+/*****************************************************************************/
+static void blit_tex(const View & view, SDL_Texture * tex, const SDL_FRect * rect, double angle, double zoom_x, double zoom_y, int flip, int overlay)
+{
+	immediateDrawList.clear();
+	push_tex_area(immediateDrawList, view, nullptr, tex, nullptr, *rect, angle, zoom_x, zoom_y, flip, overlay);
+
+	for (auto && cmd : immediateDrawList)
+	{
+		submit_tex(cmd);
+	}
+}
+
+/******************************************************************************
+ flip is one of SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL
+ *****************************************************************************/
+void sdl_blit_tex(SDL_Texture * tex, const SDL_FRect * rect, double angle, double zoom_x, double zoom_y, int flip, int overlay)
+{
+	View view;
+	get_view(get_state(), view);
+
+	blit_tex(view, tex, rect, angle, zoom_x, zoom_y, flip, overlay);
+}
+
+/*****************************************************************************/
+void sdl_blit_tex(SDL_Texture * tex, SDL_Rect * rect, double angle, double zoom_x, double zoom_y, int flip, int overlay)
+{
+	const SDL_FRect frect = make_frect(*rect);
+
+	sdl_blit_tex(tex, &frect, angle, zoom_x, zoom_y, flip, overlay);
 }
 
 /*****************************************************************************/
-static int get_current_frame(const SiAnim & anim, const bool isLoop, const Uint32 startTick)
+static int get_current_frame(const SiAnim & anim, const bool isLoop, const Uint32 startTick, const Uint32 now)
 {
 	if (anim.getTotalDuration() != 0U)
 	{
 		if (isLoop == true)
 		{
-			Uint32 tick = (globalTick - startTick) % anim.getTotalDuration();
+			Uint32 tick = (now - startTick) % anim.getTotalDuration();
 			Uint32 currentDelay = 0;
 			int frameIndex = 0;
 			for (auto && delay : anim.getDelayArray())
@@ -582,7 +1230,7 @@ static int get_current_frame(const SiAnim & anim, const bool isLoop, const Uint3
 		}
 		else
 		{
-			if (startTick + anim.getTotalDuration() < globalTick)
+			if (startTick + anim.getTotalDuration() < now)
 			{
 				return anim.getFrameQty() - 1;
 			}
@@ -592,7 +1240,7 @@ static int get_current_frame(const SiAnim & anim, const bool isLoop, const Uint3
 				int frameIndex = 0;
 				for (auto && delay : anim.getDelayArray())
 				{
-					if (tick + delay > globalTick)
+					if (tick + delay > now)
 					{
 						return frameIndex;
 					}
@@ -605,25 +1253,109 @@ static int get_current_frame(const SiAnim & anim, const bool isLoop, const Uint3
 
 	return 0;
 }
+/******************************************************************************
+ Push the current frame of an anim which is not a stream
+ return -1 if the anim has no frame
+ *****************************************************************************/
+static int push_anim(std::vector<DrawCmd> & drawList, const View & view, const SiAnim & anim, const SDL_FRect & rect, const double angle, const double zoomX,
+		const double zoomY, const bool isFlip, const bool isLoop, const bool isOverlay, const Uint32 animStartTick)
+{
+	if (anim.getFrameQty() == 0)
+	{
+		return -1;
+	}
+
+	int current_frame = get_current_frame(anim, isLoop, animStartTick, view.tick);
+
+	// Zoomed out anims are drawn from the mipmap level closest to the displayed size
+	double scale = std::max(zoomX, zoomY);
+	if (isOverlay == false)
+	{
+		scale *= view.zoom;
+	}
+	const SiAnim & level = anim.getLevelForScale(scale);
+
+	// Borrowed references: no reference counting while drawing
+	const SiAnim::Frame & frame = level.getFrame(current_frame);
+	const SDL_Rect & frameRect = frame.rect;
+	const SDL_Rect & sourceRect = frame.source;
+	const int keyFrame = frame.keyFrame;
+
+	if ((keyFrame == SiAnim::NO_KEY_FRAME) && (frameRect.x == 0) && (frameRect.y == 0) && (frameRect.w == level.getWidth())
+			&& (frameRect.h == level.getHeight()))
+	{
+		push_tex_area(drawList, view, frame.texture, nullptr, &sourceRect, rect, angle, zoomX, zoomY, isFlip, isOverlay);
+		return 0;
+	}
+
+	// Delta frame: draw the whole key frame, the changed area is drawn over it.
+	// Split key frames would show seams along the parts when scaled.
+	if (keyFrame != SiAnim::NO_KEY_FRAME)
+	{
+		const SiAnim::Frame & key = level.getFrame(keyFrame);
+
+		if (SDL_RectEmpty(&key.rect) == SDL_FALSE)
+		{
+			push_tex_part(drawList, view, key.texture, key.source, key.rect, level.getWidth(), level.getHeight(), rect, angle, zoomX, zoomY, isFlip,
+					isOverlay);
+		}
+	}
+
+	if (SDL_RectEmpty(&frameRect) == SDL_FALSE)
+	{
+		push_tex_part(drawList, view, frame.texture, sourceRect, frameRect, level.getWidth(), level.getHeight(), rect, angle, zoomX, zoomY, isFlip,
+				isOverlay);
+	}
+
+	return 0;
+}
+
 /******************************************************************************
  return 0 if blit OK
  return -1 if blit NOK
  *****************************************************************************/
-int sdl_blit_anim(const SiAnim & anim, SDL_Rect * rect, const double angle, const double zoomX, const double zoomY, const bool isFlip, const bool isLoop,
-		const bool isOverlay, const Uint32 animStartTick)
+static int blit_anim(const View & view, const SiAnim & anim, const SDL_FRect * rect, const double angle, const double zoomX, const double zoomY,
+		const bool isFlip, const bool isLoop, const bool isOverlay, const Uint32 animStartTick)
 {
-	if (anim.getTextureArray().size() == 0)
+	if (anim.getStream() != nullptr)
 	{
-		return -1;
+		blit_tex(view, anim.getStream()->getTexture(animStartTick, isLoop), rect, angle, zoomX, zoomY, isFlip, isOverlay);
+		return 0;
 	}
 
-	int current_frame = get_current_frame(anim, isLoop, animStartTick);
+	immediateDrawList.clear();
+	if (push_anim(immediateDrawList, view, anim, *rect, angle, zoomX, zoomY, isFlip, isLoop, isOverlay, animStartTick) == -1)
+	{
+		return -1;
+	}
 
-	sdl_blit_tex(anim.getTexture(current_frame)->getTexture(), rect, angle, zoomX, zoomY, isFlip, isOverlay);
+	for (auto && cmd : immediateDrawList)
+	{
+		submit_tex(cmd);
+	}
 
 	return 0;
 }
 
+/*****************************************************************************/
+int sdl_blit_anim(const SiAnim & anim, const SDL_FRect * rect, const double angle, const double zoomX, const double zoomY, const bool isFlip,
+		const bool isLoop, const bool isOverlay, const Uint32 animStartTick)
+{
+	View view;
+	get_view(get_state(), view);
+
+	return blit_anim(view, anim, rect, angle, zoomX, zoomY, isFlip, isLoop, isOverlay, animStartTick);
+}
+
+/*****************************************************************************/
+int sdl_blit_anim(const SiAnim & anim, SDL_Rect * rect, const double angle, const double zoomX, const double zoomY, const bool isFlip, const bool isLoop,
+		const bool isOverlay, const Uint32 animStartTick)
+{
+	const SDL_FRect frect = make_frect(*rect);
+
+	return sdl_blit_anim(anim, &frect, angle, zoomX, zoomY, isFlip, isLoop, isOverlay, animStartTick);
+}
+
 /*****************************************************************************/
 void sdl_get_string_size(TTF_Font * font, const std::string & text, int * w, int *h)
 {
@@ -636,24 +1368,29 @@ void sdl_get_string_size(TTF_Font * font, const std::string & text, int * w, int
 }
 
 /*****************************************************************************/
-void sdl_print_item(SdlItem & item)
+static void print_item(const View & view, SiItemStore & store, const int index)
 {
-	if (item.getText().empty() == true)
+	if (store.isFlag(index, SiItemStore::FLAG_TEXT) == false)
 	{
 		return;
 	}
 
-	if (item.getFont() == nullptr)
+	SiItemStore::Extra & extra = store.getExtra(store.getHandle(index));
+
+	if (extra.font == nullptr)
 	{
 		return;
 	}
 
+	const SDL_Rect & itemRect = store.getRectArray()[index];
+	const SiItemStore::Transform & transform = store.getTransformArray()[index];
+	const bool isOverlay = store.isFlag(index, SiItemStore::FLAG_OVERLAY);
 	int textWidth = 0;
 	int textHeight = 0;
-	int backgroundWidth = item.getRect().w;
-	int backgroundHeight = item.getRect().h;
+	int backgroundWidth = itemRect.w;
+	int backgroundHeight = itemRect.h;
 
-	TTF_SizeText(item.getFont(), item.getText().c_str(), &textWidth, &textHeight);
+	TTF_SizeText(extra.font, extra.text.c_str(), &textWidth, &textHeight);
 
 	if (backgroundWidth < textWidth)
 	{
@@ -665,43 +1402,60 @@ void sdl_print_item(SdlItem & item)
 		backgroundHeight = textHeight;
 	}
 
-	SDL_Rect rect =
-	{ 0, 0, 0, 0 };
+	double itemX = 0.0;
+	double itemY = 0.0;
+	get_item_pos(view, store, index, itemX, itemY);
 
-	rect.x = item.getRect().x;
-	rect.y = item.getRect().y;
+	SDL_FRect rect =
+	{ (float) itemX, (float) itemY, 0, 0 };
 
-	if (item.getBackGroudColor() != 0)
+	if (extra.backGroudColor != 0)
 	{
 		rect.w = backgroundWidth;
 		rect.h = backgroundHeight;
-		SiAnim * bgAnim = anim_create_color(rect.w, rect.h, item.getBackGroudColor());
-		sdl_blit_anim(*bgAnim, &rect, item.getAngle(), item.getZoomX(), item.getZoomY(), item.getFlip(), false, item.isOverlay(), 0);
+		SiAnim * bgAnim = anim_create_color(backgroundWidth, backgroundHeight, extra.backGroudColor);
+		blit_anim(view, *bgAnim, &rect, transform.angle, transform.zoomX, transform.zoomY, transform.flip, false, isOverlay, 0);
 		delete bgAnim;
 	}
 
-	if (item.getTextTexture() == nullptr)
+	if (extra.textTexture == nullptr)
 	{
 		SDL_Color fg =
 		{ 0xff, 0xff, 0xff };
 
-		SDL_Surface * surf = TTF_RenderText_Blended(item.getFont(), item.getText().c_str(), fg);
-		item.setTextTexture(SDL_CreateTextureFromSurface(renderer, surf));
+		SDL_Surface * surf = TTF_RenderText_Blended(extra.font, extra.text.c_str(), fg);
+		extra.textTexture = tracker_create_texture_from_surface(surf, TextureOrigin::TEXT);
 		SDL_FreeSurface(surf);
 	}
 
 	rect.w = textWidth;
 	rect.h = textHeight;
-	sdl_blit_tex(item.getTextTexture(), &rect, item.getAngle(), item.getZoomX(), item.getZoomY(), item.getFlip(), item.isOverlay());
+	blit_tex(view, extra.textTexture, &rect, transform.angle, transform.zoomX, transform.zoomY, transform.flip, isOverlay);
 }
 
 /*****************************************************************************/
-static void sdl_blit_anim_array(const SdlItem & item, const std::vector<SiAnim *> & animArray)
+void sdl_print_item(SdlItem & item)
+{
+	SiItemStore & store = item.getStore();
+	View view;
+	get_view(get_state(), view);
+
+	print_item(view, store, store.getIndex(item.getHandle()));
+}
+
+/******************************************************************************
+ Streams are drawn when submitted, the other anims are pushed here
+ *****************************************************************************/
+static void push_anim_array(std::vector<DrawCmd> & drawList, const View & view, const SiItemStore & store, const int index,
+		const SiItemStore::AnimSet set)
 {
+	const std::vector<SiAnim *> & animArray = store.getAnim(index, set);
+	const SiItemStore::Transform & transform = store.getTransformArray()[index];
+	const bool isCenter = store.isFlag(index, SiItemStore::FLAG_LAYOUT_CENTER);
 	int max_width = 0;
 	int max_height = 0;
 
-	if (item.getLayout() == SdlItem::Layout::CENTER)
+	if (isCenter == true)
 	{
 		for (auto && anim : animArray)
 		{
@@ -716,41 +1470,147 @@ static void sdl_blit_anim_array(const SdlItem & item, const std::vector<SiAnim *
 		}
 	}
 
-	SDL_Rect rect =
+	double itemX = 0.0;
+	double itemY = 0.0;
+	get_item_pos(view, store, index, itemX, itemY);
+
+	SDL_FRect rect =
 	{ 0, 0, 0, 0 };
 
 	for (auto anim : animArray)
 	{
-		switch (item.getLayout())
+		if (isCenter == true)
 		{
-		case SdlItem::Layout::CENTER:
-			rect.x = item.getRect().x + ((max_width - anim->getWidth()) / 2);
-			rect.y = item.getRect().y + ((max_height - anim->getHeight()) / 2);
-			break;
-
-		case SdlItem::Layout::TOP_LEFT:
-		default:
-			rect.x = item.getRect().x;
-			rect.y = item.getRect().y;
-			break;
+			rect.x = itemX + ((max_width - anim->getWidth()) / 2);
+			rect.y = itemY + ((max_height - anim->getHeight()) / 2);
+		}
+		else
+		{
+			rect.x = itemX;
+			rect.y = itemY;
 		}
 
 		rect.w = anim->getWidth();
 		rect.h = anim->getHeight();
 
-		sdl_blit_anim(*anim, &rect, item.getAngle(), item.getZoomX(), item.getZoomY(), item.getFlip(), item.isAnimLoop(), item.isOverlay(),
-				item.getAnimStartTick());
+		if (anim->getStream() != nullptr)
+		{
+			DrawCmd cmd = make_draw_cmd(DrawKind::STREAM);
+			cmd.anim = anim;
+			cmd.index = index;
+			cmd.dest = rect;
+			drawList.push_back(cmd);
+			continue;
+		}
+
+		push_anim(drawList, view, *anim, rect, transform.angle, transform.zoomX, transform.zoomY, transform.flip,
+				store.isFlag(index, SiItemStore::FLAG_ANIM_LOOP), store.isFlag(index, SiItemStore::FLAG_OVERLAY), transform.animStartTick);
+	}
+}
+
+/******************************************************************************
+ Frame selection and culling of an item, safe to call from any thread
+ *****************************************************************************/
+static void push_item(std::vector<DrawCmd> & drawList, const View & view, const SiItemStore & store, const int index)
+{
+	push_anim_array(drawList, view, store, index, SiItemStore::AnimSet::DEFAULT);
+	push_anim_array(drawList, view, store, index, SiItemStore::AnimSet::CLICK);
+	push_anim_array(drawList, view, store, index, SiItemStore::AnimSet::OVER);
+
+	if (store.isFlag(index, SiItemStore::FLAG_TEXT) == true)
+	{
+		DrawCmd cmd = make_draw_cmd(DrawKind::TEXT);
+		cmd.index = index;
+		drawList.push_back(cmd);
+	}
+}
+
+/******************************************************************************
+ Render thread only
+ *****************************************************************************/
+static void submit_draw_list(const std::vector<DrawCmd> & drawList, const View & view, SiItemStore & store)
+{
+	for (auto && cmd : drawList)
+	{
+		switch (cmd.kind)
+		{
+		case DrawKind::TEXTURE:
+			submit_tex(cmd);
+			break;
+		case DrawKind::STREAM:
+		{
+			const SiItemStore::Transform & transform = store.getTransformArray()[cmd.index];
+			blit_anim(view, *cmd.anim, &cmd.dest, transform.angle, transform.zoomX, transform.zoomY, transform.flip,
+					store.isFlag(cmd.index, SiItemStore::FLAG_ANIM_LOOP), store.isFlag(cmd.index, SiItemStore::FLAG_OVERLAY), transform.animStartTick);
+		}
+			break;
+		case DrawKind::TEXT:
+			print_item(view, store, cmd.index);
+			break;
+		}
+	}
+}
+
+/******************************************************************************
+ Restrict drawing to the viewport of camera, if it has one.
+ The previous clip rect is saved to be restored by unclip_viewport()
+ *****************************************************************************/
+static void clip_viewport(const SiCamera & camera, bool & isClipped, SDL_Rect & previous)
+{
+	SdlItemContext::State & state = get_state();
+
+	isClipped = SDL_RenderIsClipEnabled(state.renderer) == SDL_TRUE;
+	SDL_RenderGetClipRect(state.renderer, &previous);
+
+	if (SDL_RectEmpty(&camera.getViewport()) == SDL_FALSE)
+	{
+		SDL_RenderSetClipRect(state.renderer, &camera.getViewport());
+	}
+}
+
+/*****************************************************************************/
+static void unclip_viewport(const SiCamera & camera, const bool isClipped, const SDL_Rect & previous)
+{
+	SdlItemContext::State & state = get_state();
+
+	if (SDL_RectEmpty(&camera.getViewport()) == SDL_TRUE)
+	{
+		return;
+	}
+
+	if (isClipped == true)
+	{
+		SDL_RenderSetClipRect(state.renderer, &previous);
+	}
+	else
+	{
+		SDL_RenderSetClipRect(state.renderer, nullptr);
 	}
 }
 
 /*****************************************************************************/
 int sdl_blit_item(SdlItem & item)
 {
-	sdl_blit_anim_array(item, item.getAnim());
-	sdl_blit_anim_array(item, item.getAnimClick());
-	sdl_blit_anim_array(item, item.getAnimOver());
+	return sdl_blit_item(item, get_state().camera);
+}
+
+/*****************************************************************************/
+int sdl_blit_item(SdlItem & item, const SiCamera & camera)
+{
+	SiItemStore & store = item.getStore();
+	View view;
+	get_view(get_state(), camera, view);
+
+	bool isClipped = false;
+	SDL_Rect previous =
+	{ 0, 0, 0, 0 };
+	clip_viewport(camera, isClipped, previous);
 
-	sdl_print_item(item);
+	itemDrawList.clear();
+	push_item(itemDrawList, view, store, store.getIndex(item.getHandle()));
+	submit_draw_list(itemDrawList, view, store);
+
+	unclip_viewport(camera, isClipped, previous);
 
 	return 0;
 }
@@ -764,9 +1624,60 @@ void sdl_blit_item_list(std::vector<SdlItem> & itemArray)
 	}
 }
 
+/*****************************************************************************/
+void sdl_blit_store(SiItemStore & store)
+{
+	sdl_blit_store(store, get_state().camera);
+}
+
+/******************************************************************************
+ Items are drawn in creation order. Draw lists of chunks of items are built
+ in parallel, then submitted in chunk order by the calling thread.
+ *****************************************************************************/
+void sdl_blit_store(SiItemStore & store, const SiCamera & camera)
+{
+	View view;
+	get_view(get_state(), camera, view);
+
+	// Lists of the calling thread, jobs must not use their own thread_local copy
+	std::vector<std::vector<DrawCmd>> & chunkDrawLists = chunkDrawListArray;
+	// Sorted here, jobs only read it
+	const std::vector<int> & orderArray = store.getOrderArray();
+	const int chunkQty = SiJobSystem::getChunkQty(store.getQty(), ITEM_CHUNK_SIZE);
+	if ((int) chunkDrawLists.size() < chunkQty)
+	{
+		chunkDrawLists.resize(chunkQty);
+	}
+
+	SiJobSystem::getDefault().parallelFor(store.getQty(), ITEM_CHUNK_SIZE, [&](int chunk, int begin, int end)
+	{
+		std::vector<DrawCmd> & drawList = chunkDrawLists[chunk];
+		drawList.clear();
+
+		for (int position = begin; position < end; position++)
+		{
+			push_item(drawList, view, store, orderArray[position]);
+		}
+	});
+
+	bool isClipped = false;
+	SDL_Rect previous =
+	{ 0, 0, 0, 0 };
+	clip_viewport(camera, isClipped, previous);
+
+	for (int chunk = 0; chunk < chunkQty; chunk++)
+	{
+		submit_draw_list(chunkDrawLists[chunk], view, store);
+	}
+
+	unclip_viewport(camera, isClipped, previous);
+}
+
 /*****************************************************************************/
 bool sdl_keyboard_manager(SDL_Event * event)
 {
+	SdlItemContext::State & state = get_state();
+
 	const Uint8 *keystate = nullptr;
 
 	switch (event->type)
@@ -774,7 +1685,7 @@ bool sdl_keyboard_manager(SDL_Event * event)
 	case SDL_KEYUP:
 		if (event->key.repeat == 0)
 		{
-			for (auto && key : keyCbArray)
+			for (auto && key : state.keyCbArray)
 			{
 				if (event->key.keysym.scancode == key.getCode())
 				{
@@ -789,9 +1700,9 @@ bool sdl_keyboard_manager(SDL_Event * event)
 	case SDL_KEYDOWN:
 		if (event->key.repeat == 0)
 		{
-			if (focusedItem == nullptr)
+			if (state.focusedStore == nullptr)
 			{
-				for (auto && key : keyCbArray)
+				for (auto && key : state.keyCbArray)
 				{
 					if (event->key.keysym.scancode == key.getCode())
 					{
@@ -805,15 +1716,28 @@ bool sdl_keyboard_manager(SDL_Event * event)
 		}
 		else
 		{
+			if ((state.focusedStore == nullptr) || (state.focusedStore->isValid(state.focusedItem) == false))
+			{
+				break;
+			}
+
 			// Keys are used to enter text
+			SiItemStore::Extra & extra = state.focusedStore->getExtra(state.focusedItem);
+
 			if (event->key.keysym.sym == SDLK_RETURN)
 			{
-				focusedItem->getEditCb()(focusedItem->getText());
+				const int index = state.focusedStore->getIndex(state.focusedItem);
+				if (state.focusedStore->isFlag(index, SiItemStore::HANDLER_EDIT) == true)
+				{
+					const std::function<void(std::string)> editCb = state.focusedStore->findHandlers(state.focusedItem)->editCb;
+					editCb(extra.text);
+				}
+				return true;
 			}
 
 			if (event->key.keysym.sym == SDLK_DELETE || event->key.keysym.sym == SDLK_BACKSPACE)
 			{
-				focusedItem->removeFromText(1);
+				state.focusedStore->setText(state.focusedItem, extra.text.substr(0, extra.text.size() - 1));
 			}
 
 			if (event->key.keysym.sym >= SDLK_SPACE && event->key.keysym.sym < SDLK_DELETE)
@@ -828,7 +1752,7 @@ bool sdl_keyboard_manager(SDL_Event * event)
 				char keyString[2];
 				keyString[0] = (char) (event->key.keysym.sym);
 				keyString[1] = 0;
-				focusedItem->addToText(std::string(keyString));
+				state.focusedStore->setText(state.focusedItem, extra.text + std::string(keyString));
 			}
 			return true;
 		}
@@ -843,132 +1767,264 @@ bool sdl_keyboard_manager(SDL_Event * event)
 /*****************************************************************************/
 void sdl_blit_to_screen()
 {
-	SDL_RenderPresent(renderer);
+	SdlItemContext::State & state = get_state();
+
+	SDL_RenderPresent(state.renderer);
+}
+
+/******************************************************************************
+ The camera moves to x in VIRTUAL_CAMERA_ANIM_DURATION ms
+ *****************************************************************************/
+void sdl_set_virtual_xf(const double x)
+{
+	SdlItemContext::State & state = get_state();
+
+	state.camera.setX(x, state.globalTick);
 }
 
 /*****************************************************************************/
 void sdl_set_virtual_x(int x)
 {
-	old_vx = current_vx;
-	if (x != virtual_x)
-	{
-		virtual_x = x;
-		virtual_tick = globalTick;
-	}
+	sdl_set_virtual_xf(x);
+}
+
+/******************************************************************************
+ The camera moves to y in VIRTUAL_CAMERA_ANIM_DURATION ms
+ *****************************************************************************/
+void sdl_set_virtual_yf(const double y)
+{
+	SdlItemContext::State & state = get_state();
+
+	state.camera.setY(y, state.globalTick);
 }
 
 /*****************************************************************************/
 void sdl_set_virtual_y(int y)
 {
-	old_vy = current_vy;
-	if (y != virtual_y)
-	{
-		virtual_y = y;
-		virtual_tick = globalTick;
-	}
+	sdl_set_virtual_yf(y);
 }
 
 /*****************************************************************************/
 void sdl_set_virtual_z(double z)
 {
-	if (z != virtual_z)
-	{
-		old_vz = currentVz;
-		virtual_z = z;
-		virtual_tick = globalTick;
-	}
+	SdlItemContext::State & state = get_state();
+
+	state.camera.setZoom(z, state.globalTick);
 }
 
 /*****************************************************************************/
 int sdl_get_virtual_x()
 {
-	return virtual_x;
+	return lround(get_state().camera.getX());
+}
+
+/*****************************************************************************/
+double sdl_get_virtual_xf()
+{
+	return get_state().camera.getX();
 }
 
 /*****************************************************************************/
 int sdl_get_virtual_y()
 {
-	return virtual_y;
+	return lround(get_state().camera.getY());
+}
+
+/*****************************************************************************/
+double sdl_get_virtual_yf()
+{
+	return get_state().camera.getY();
 }
 
 /*****************************************************************************/
 double sdl_get_virtual_z()
 {
-	return virtual_z;
+	return get_state().camera.getZoom();
 }
 
 /*****************************************************************************/
 void sdl_force_virtual_x(int x)
 {
-	virtual_x = x;
-	current_vx = x;
-	old_vx = x;
+	get_state().camera.forceX(x);
 }
 
 /*****************************************************************************/
 void sdl_force_virtual_y(int y)
 {
-	virtual_y = y;
-	current_vy = y;
-	old_vy = y;
+	get_state().camera.forceY(y);
 }
 
 /*****************************************************************************/
 void sdl_force_virtual_z(double z)
 {
-	virtual_z = z;
-	currentVz = z;
-	old_vz = z;
+	get_state().camera.forceZoom(z);
+}
+
+/*****************************************************************************/
+SiCamera & sdl_get_camera()
+{
+	return get_state().camera;
+}
+
+/******************************************************************************
+ camera is moved by sdl_loop_manager() until sdl_remove_camera() is called
+ *****************************************************************************/
+void sdl_add_camera(SiCamera & camera)
+{
+	SdlItemContext::State & state = get_state();
+
+	if (std::find(state.cameraArray.begin(), state.cameraArray.end(), &camera) == state.cameraArray.end())
+	{
+		state.cameraArray.push_back(&camera);
+	}
+}
+
+/*****************************************************************************/
+void sdl_remove_camera(SiCamera & camera)
+{
+	SdlItemContext::State & state = get_state();
+
+	state.cameraArray.erase(std::remove(state.cameraArray.begin(), state.cameraArray.end(), &camera), state.cameraArray.end());
 }
 
 /*****************************************************************************/
 void sdl_add_down_key_cb(const SDL_Scancode code, const std::function<void()> & downCb)
 {
+	SdlItemContext::State & state = get_state();
+
 	struct SiKeyCallback key;
 
 	key.setCode(code);
 	key.setDownCallBack(downCb);
 
-	keyCbArray.push_back(key);
+	state.keyCbArray.push_back(key);
 }
 
 /*****************************************************************************/
 void sdl_add_up_key_cb(const SDL_Scancode code, const std::function<void()> & upCb)
 {
+	SdlItemContext::State & state = get_state();
+
 	struct SiKeyCallback key;
 
 	key.setCode(code);
 	key.setUpCallBack(upCb);
 
-	keyCbArray.push_back(key);
+	state.keyCbArray.push_back(key);
 }
 
 /*****************************************************************************/
 void sdl_clean_key_cb()
 {
-	keyCbArray.clear();
+	SdlItemContext::State & state = get_state();
+
+	state.keyCbArray.clear();
 }
 
 /*****************************************************************************/
 void sdl_add_mousecb(Uint32 eventType, std::function<void()> callBack)
 {
+	SdlItemContext::State & state = get_state();
+
 	SiMouseEvent mouseEvent;
 	mouseEvent.setEventType(eventType);
 	mouseEvent.setCallBack(callBack);
 
-	globalMouseEventArray.push_back(mouseEvent);
+	state.mouseEventArray.push_back(mouseEvent);
 }
 
 /*****************************************************************************/
 void sdl_free_mousecb()
 {
-	globalMouseEventArray.clear();
+	SdlItemContext::State & state = get_state();
+
+	state.mouseEventArray.clear();
+}
+
+/******************************************************************************
+ Draw at whole pixel positions and sizes, as pixel art needs. Positions are
+ sub-pixel otherwise, for smooth camera moves and zooms.
+ *****************************************************************************/
+void sdl_set_pixel_snap(const bool isPixelSnap)
+{
+	get_state().isPixelSnap = isPixelSnap;
+}
+
+/*****************************************************************************/
+void sdl_set_fixed_step(const int rate, const int maxStepQty, const std::function<void()> & stepCb)
+{
+	SdlItemContext::State & state = get_state();
+
+	// No step would ever run
+	if ((rate < 0) || ((rate != 0) && (maxStepQty <= 0)))
+	{
+		return;
+	}
+
+	state.stepRate = rate;
+	state.maxStepQty = maxStepQty;
+	state.stepCb = stepCb;
+	state.stepCounter = 0U;
+	state.stepLag = 0.0;
+	state.stepAlpha = 1.0;
+	save_camera_steps(state);
+}
+
+/*****************************************************************************/
+void sdl_add_step_store(SiItemStore & store)
+{
+	SdlItemContext::State & state = get_state();
+
+	if (std::find(state.stepStoreArray.begin(), state.stepStoreArray.end(), &store) == state.stepStoreArray.end())
+	{
+		state.stepStoreArray.push_back(&store);
+	}
+}
+
+/******************************************************************************
+ Items of store are drawn at their current position from now on
+ *****************************************************************************/
+void sdl_remove_step_store(SiItemStore & store)
+{
+	SdlItemContext::State & state = get_state();
+
+	state.stepStoreArray.erase(std::remove(state.stepStoreArray.begin(), state.stepStoreArray.end(), &store), state.stepStoreArray.end());
+
+	for (int index = 0; index < store.getQty(); index++)
+	{
+		store.setFlag(index, SiItemStore::FLAG_SNAP, true);
+	}
+}
+
+/*****************************************************************************/
+double sdl_get_step_alpha()
+{
+	SdlItemContext::State & state = get_state();
+
+	if (state.stepRate == 0)
+	{
+		return 1.0;
+	}
+
+	return state.stepAlpha;
 }
 
 /*****************************************************************************/
 Uint32 sdl_get_global_time()
 {
-	return globalTick;
+	return get_state().globalTick;
+}
+
+/******************************************************************************
+ Textures of frames loaded with SiLoadOption::isLazyTexture are released
+ when not drawn for delay milliseconds. 0 keeps them until the anim is
+ deleted.
+ *****************************************************************************/
+void sdl_set_texture_release_delay(const Uint32 delay)
+{
+	SdlItemContext::State & state = get_state();
+
+	state.textureReleaseDelay = delay;
 }
 
 /*****************************************************************************/
@@ -976,7 +2032,7 @@ SiAnim * sdl_get_minimal_anim()
 {
 	SiAnim * def_anim = new SiAnim;
 
-	def_anim->pushTexture(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STATIC, 1, 1));
+	def_anim->pushTexture(tracker_create_texture(SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STATIC, 1, 1, TextureOrigin::MINIMAL_ANIM));
 	def_anim->setWidth(1);
 	def_anim->setHeight(1);
 	def_anim->pushDelay(0U);
@@ -988,18 +2044,24 @@ SiAnim * sdl_get_minimal_anim()
 /*****************************************************************************/
 void sdl_set_background_color(int R, int G, int B, int A)
 {
-	SDL_SetRenderDrawColor(renderer, R, G, B, A);
+	SdlItemContext::State & state = get_state();
+
+	SDL_SetRenderDrawColor(state.renderer, R, G, B, A);
 }
 
 /*****************************************************************************/
 void sdl_get_output_size(int * width, int * height)
 {
-	SDL_GetRendererOutputSize(renderer, width, height);
+	SdlItemContext::State & state = get_state();
+
+	SDL_GetRendererOutputSize(state.renderer, width, height);
 }
 
 /*****************************************************************************/
 void sdl_clear()
 {
-	SDL_RenderClear(renderer);
+	SdlItemContext::State & state = get_state();
+
+	SDL_RenderClear(state.renderer);
 }
 
@@ -0,0 +1,109 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+/******************************************************************************
+ sdl_item_pack: decode anims ahead of time into an asset pack read by SiPack
+
+ usage: sdl_item_pack [-b] [-t] PACK_FILE ANIM_FILE...
+ -b: store pixels as BGRA instead of RGBA. Use the format listed first by
+     the target renderer (see sdl_get_texture_format()) so that frames
+     are uploaded without conversion.
+ -t: crop frames to their non transparent pixels (see SiLoadOption::isTrim)
+
+ Anims are named after ANIM_FILE as it is written on the command line.
+ *****************************************************************************/
+
+#include "reader.h"
+#include "si_pack.h"
+#include "SiAnim.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*****************************************************************************/
+static void usage(const char * name)
+{
+	fprintf(stderr, "usage: %s [-b] [-t] PACK_FILE ANIM_FILE...\n", name);
+}
+
+/*****************************************************************************/
+int main(int argc, char ** argv)
+{
+	Uint32 format = SDL_PIXELFORMAT_RGBA32;
+	SiLoadOption option;
+	option.isNoTexture = true;
+	int arg = 1;
+
+	for (; (arg < argc) && (argv[arg][0] == '-'); arg++)
+	{
+		if (strcmp(argv[arg], "-b") == 0)
+		{
+			format = SDL_PIXELFORMAT_BGRA32;
+		}
+		else if (strcmp(argv[arg], "-t") == 0)
+		{
+			option.isTrim = true;
+		}
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (argc - arg < 2)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	const std::string packPath = argv[arg];
+	arg++;
+
+	std::vector<std::pair<std::string, SiAnim *>> animArray;
+	int ret = 0;
+
+	for (; arg < argc; arg++)
+	{
+		SiAnim * anim = anim_load(argv[arg], option);
+		if (anim == nullptr)
+		{
+			fprintf(stderr, "%s: cannot decode %s\n", argv[0], argv[arg]);
+			ret = 1;
+			break;
+		}
+
+		animArray.push_back(std::make_pair(std::string(argv[arg]), anim));
+	}
+
+	if ((ret == 0) && (pack_write(packPath, animArray, format) == false))
+	{
+		fprintf(stderr, "%s: cannot write %s\n", argv[0], packPath.c_str());
+		ret = 1;
+	}
+
+	for (auto && anim : animArray)
+	{
+		delete anim.second;
+	}
+
+	return ret;
+}
@@ -0,0 +1,237 @@
+/*
+ World of Gnome is a 2D multiplayer role playing game.
+ Copyright (C) 2020 carabobz@gmail.com
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ */
+
+#include "sdl.h"
+#include "tracker.h"
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+static constexpr int ORIGIN_QTY = (int) TextureOrigin::PACK + 1;
+
+struct TextureRecord
+{
+	Uint32 format;
+	int width;
+	int height;
+	Uint64 byteQty;
+	TextureOrigin origin;
+};
+
+static std::mutex trackerMutex;
+static std::unordered_map<SDL_Texture *, TextureRecord> recordMap;
+static Uint64 byteQty[ORIGIN_QTY];
+static int textureQty[ORIGIN_QTY];
+static Uint64 totalByteQty = 0U;
+static Uint64 budget = 0U;
+static std::function<void(Uint64)> budgetCb;
+
+/*****************************************************************************/
+static const char * get_origin_name(const TextureOrigin origin)
+{
+	switch (origin)
+	{
+	case TextureOrigin::LOADER:
+		return "loader";
+	case TextureOrigin::COLOR:
+		return "color";
+	case TextureOrigin::TEXT:
+		return "text";
+	case TextureOrigin::MINIMAL_ANIM:
+		return "minimal anim";
+	case TextureOrigin::STREAM:
+		return "stream";
+	case TextureOrigin::PACK:
+		return "pack";
+	}
+
+	return "unknown";
+}
+
+/*****************************************************************************/
+static Uint64 get_byte_qty(const Uint32 format, const int width, const int height)
+{
+	// Planar YUV: full size luma plus two quarter size chroma planes
+	if ((format == SDL_PIXELFORMAT_IYUV) || (format == SDL_PIXELFORMAT_YV12))
+	{
+		return (Uint64) width * height + 2U * (Uint64) ((width + 1) / 2) * ((height + 1) / 2);
+	}
+
+	return (Uint64) width * height * SDL_BYTESPERPIXEL(format);
+}
+
+/*****************************************************************************/
+static void record(SDL_Texture * texture, const TextureOrigin origin)
+{
+	if (texture == nullptr)
+	{
+		return;
+	}
+
+	TextureRecord textureRecord;
+	int access = 0;
+	SDL_QueryTexture(texture, &textureRecord.format, &access, &textureRecord.width, &textureRecord.height);
+	textureRecord.byteQty = get_byte_qty(textureRecord.format, textureRecord.width, textureRecord.height);
+	textureRecord.origin = origin;
+
+	std::function<void(Uint64)> cb;
+	Uint64 total = 0U;
+
+	{
+		std::lock_guard<std::mutex> lock(trackerMutex);
+
+		recordMap[texture] = textureRecord;
+		byteQty[(int) origin] += textureRecord.byteQty;
+		textureQty[(int) origin]++;
+
+		const Uint64 previousTotal = totalByteQty;
+		totalByteQty += textureRecord.byteQty;
+		total = totalByteQty;
+
+		// Only call back when the budget is crossed
+		if ((budget != 0U) && (previousTotal <= budget) && (totalByteQty > budget))
+		{
+			cb = budgetCb;
+		}
+	}
+
+	if (cb)
+	{
+		cb(total);
+	}
+}
+
+/*****************************************************************************/
+SDL_Texture * tracker_create_texture(const Uint32 format, const int access, const int width, const int height, const TextureOrigin origin)
+{
+	SDL_Texture * texture = SDL_CreateTexture(sdl_get_renderer(), format, access, width, height);
+
+	record(texture, origin);
+
+	return texture;
+}
+
+/*****************************************************************************/
+SDL_Texture * tracker_create_texture_from_surface(SDL_Surface * surface, const TextureOrigin origin)
+{
+	SDL_Texture * texture = SDL_CreateTextureFromSurface(sdl_get_renderer(), surface);
+
+	record(texture, origin);
+
+	return texture;
+}
+
+/*****************************************************************************/
+void tracker_destroy_texture(SDL_Texture * texture)
+{
+	if (texture == nullptr)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(trackerMutex);
+
+		auto it = recordMap.find(texture);
+		if (it != recordMap.end())
+		{
+			byteQty[(int) it->second.origin] -= it->second.byteQty;
+			textureQty[(int) it->second.origin]--;
+			totalByteQty -= it->second.byteQty;
+			recordMap.erase(it);
+		}
+	}
+
+	SDL_DestroyTexture(texture);
+}
+
+/*****************************************************************************/
+Uint64 tracker_get_byte_qty()
+{
+	std::lock_guard<std::mutex> lock(trackerMutex);
+
+	return totalByteQty;
+}
+
+/*****************************************************************************/
+Uint64 tracker_get_byte_qty(const TextureOrigin origin)
+{
+	std::lock_guard<std::mutex> lock(trackerMutex);
+
+	return byteQty[(int) origin];
+}
+
+/*****************************************************************************/
+int tracker_get_texture_qty()
+{
+	std::lock_guard<std::mutex> lock(trackerMutex);
+
+	return recordMap.size();
+}
+
+/*****************************************************************************/
+int tracker_get_texture_qty(const TextureOrigin origin)
+{
+	std::lock_guard<std::mutex> lock(trackerMutex);
+
+	return textureQty[(int) origin];
+}
+
+/*****************************************************************************/
+void tracker_dump(const int qty)
+{
+	std::lock_guard<std::mutex> lock(trackerMutex);
+
+	SDL_Log("%d textures, %llu bytes", (int) recordMap.size(), (unsigned long long) totalByteQty);
+
+	for (int i = 0; i < ORIGIN_QTY; i++)
+	{
+		SDL_Log("  %s: %d textures, %llu bytes", get_origin_name((TextureOrigin) i), textureQty[i], (unsigned long long) byteQty[i]);
+	}
+
+	std::vector<std::pair<SDL_Texture *, TextureRecord>> recordArray(recordMap.begin(), recordMap.end());
+
+	int topQty = (int) recordArray.size();
+	if ((qty >= 0) && (qty < topQty))
+	{
+		topQty = qty;
+	}
+	std::partial_sort(recordArray.begin(), recordArray.begin() + topQty, recordArray.end(),
+			[](const std::pair<SDL_Texture *, TextureRecord> & a, const std::pair<SDL_Texture *, TextureRecord> & b)
+			{
+				return a.second.byteQty > b.second.byteQty;
+			});
+
+	for (int i = 0; i < topQty; i++)
+	{
+		const TextureRecord & textureRecord = recordArray[i].second;
+		SDL_Log("  %p: %dx%d %s, %s, %llu bytes", (void *) recordArray[i].first, textureRecord.width, textureRecord.height,
+				SDL_GetPixelFormatName(textureRecord.format), get_origin_name(textureRecord.origin), (unsigned long long) textureRecord.byteQty);
+	}
+}
+
+/*****************************************************************************/
+void tracker_set_budget(const Uint64 newBudget, const std::function<void(Uint64)> & newBudgetCb)
+{
+	std::lock_guard<std::mutex> lock(trackerMutex);
+
+	budget = newBudget;
+	budgetCb = newBudgetCb;
+}